@@ -0,0 +1,75 @@
+#include "BVH.h"
+#include <algorithm>
+
+using namespace std;
+
+void BVH::Build(const vector<IRect>& Boxes)
+{
+    boxes = Boxes;
+    order.resize(boxes.size());
+    nodes.clear();
+    if(boxes.empty()) return;
+    
+    for(int32 i = 0; i < (int32)order.size(); i++)
+    {
+        order[i] = i;
+    }
+    
+    // A balanced binary tree with leaves of up to LeafSize boxes needs fewer than 2N nodes.
+    nodes.reserve(2 * (boxes.size() / LeafSize + 1));
+    nodes.push_back(Node());
+    BuildNode(0, 0, order.size());
+}
+
+void BVH::BuildNode(int32 NodeIndex, int32 Begin, int32 End)
+{
+    const IRect& first = boxes[order[Begin]];
+    int32 left = first.Left(), top = first.Top(), right = first.Right(), bottom = first.Bottom();
+    int32 minX = first.CenterX(), maxX = minX, minY = first.CenterY(), maxY = minY;
+    
+    for(int32 i = Begin + 1; i < End; i++)
+    {
+        const IRect& box = boxes[order[i]];
+        left = min(left, box.Left());
+        top = min(top, box.Top());
+        right = max(right, box.Right());
+        bottom = max(bottom, box.Bottom());
+        minX = min(minX, box.CenterX());
+        maxX = max(maxX, box.CenterX());
+        minY = min(minY, box.CenterY());
+        maxY = max(maxY, box.CenterY());
+    }
+    
+    Node node = { left, top, right, bottom, Begin, End - Begin };
+    if(End - Begin > LeafSize)
+    {
+        // Split at the median centre along the longer axis, ties broken on index so the tree is deterministic.
+        bool alongX = (maxX - minX) >= (maxY - minY);
+        int32 mid = (Begin + End) / 2;
+        const vector<IRect>& b = boxes;
+        nth_element(order.begin() + Begin, order.begin() + mid, order.begin() + End, [&](int32 l, int32 r)
+        {
+            int32 cl = alongX ? b[l].CenterX() : b[l].CenterY();
+            int32 cr = alongX ? b[r].CenterX() : b[r].CenterY();
+            return (cl < cr) || (cl == cr && l < r);
+        });
+        
+        node.First = nodes.size();
+        node.Count = 0;
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        BuildNode(node.First, Begin, mid);
+        BuildNode(node.First + 1, mid, End);
+    }
+    nodes[NodeIndex] = node;
+}
+
+void BVH::Query(const IRect& Area, vector<int32>& Result) const
+{
+    Result.clear();
+    Query(Area, [&](int32 index)
+    {
+        Result.push_back(index);
+    });
+    sort(Result.begin(), Result.end());
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include "IRect.h"
+#include "Helper.h"
+
+/**
+ * Bounding volume hierarchy over a fixed set of rectangles.
+ *
+ * The tree is built top down, splitting each node at the median centre along
+ * its longer axis, so it is balanced and a query visits O(log N + K) nodes for
+ * K results. Rectangles are treated as closed, a box touching another only at
+ * its Right() or Bottom() edge still counts as overlapping.
+ */
+class BVH
+{
+public:
+    BVH() {}
+    BVH(const std::vector<IRect>& Boxes) { Build(Boxes); }
+    
+    /** Rebuild the tree over Boxes, results are reported as indices into Boxes. **/
+    void Build(const std::vector<IRect>& Boxes);
+    
+    int32 Size() const { return boxes.size(); }
+    const IRect& Box(int32 Index) const { return boxes[Index]; }
+    
+    /** Call fn(index) for every box that overlaps Area. **/
+    template<typename Fn>
+    void Query(const IRect& Area, Fn fn) const
+    {
+        if(nodes.empty()) return;
+        
+        int32 stack[64];
+        int32 top = 0;
+        stack[top++] = 0;
+        
+        while(top > 0)
+        {
+            const Node& node = nodes[stack[--top]];
+            if(node.Left > Area.Right() || node.Right < Area.Left() ||
+               node.Top > Area.Bottom() || node.Bottom < Area.Top())
+            {
+                continue;
+            }
+            
+            if(node.Count == 0)
+            {
+                stack[top++] = node.First;
+                stack[top++] = node.First + 1;
+                continue;
+            }
+            
+            for(int32 i = node.First; i < node.First + node.Count; i++)
+            {
+                const IRect& box = boxes[order[i]];
+                if(box.Left() <= Area.Right() && box.Right() >= Area.Left() &&
+                   box.Top() <= Area.Bottom() && box.Bottom() >= Area.Top())
+                {
+                    fn(order[i]);
+                }
+            }
+        }
+    }
+    
+    /** Indices of every box that overlaps Area, in ascending order. **/
+    void Query(const IRect& Area, std::vector<int32>& Result) const;
+    
+private:
+    static const int32 LeafSize = 4;
+    
+    typedef struct
+    {
+        int32 Left, Top, Right, Bottom;    // Bounds of every box below this node.
+        int32 First;                       // Leaf: first entry in order. Inner: first child, the second follows it.
+        int32 Count;                       // Boxes in a leaf, 0 for an inner node.
+    } Node;
+    
+    std::vector<IRect> boxes;
+    std::vector<int32> order;
+    std::vector<Node> nodes;
+    
+    void BuildNode(int32 NodeIndex, int32 Begin, int32 End);
+};
\ No newline at end of file
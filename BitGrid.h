@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include <algorithm>
+#include "Helper.h"
+
+// Index of the lowest and highest set bit, Bits must not be 0.
+static inline int32 LowestBit(uint64_t Bits) { return __builtin_ctzll(Bits); }
+static inline int32 HighestBit(uint64_t Bits) { return 63 - __builtin_clzll(Bits); }
+
+/**
+ * A Width x Height grid of single bits, packed 64 to a word.
+ *
+ * Each row starts on a fresh word so a row can be scanned or filled a word at
+ * a time. Bits past the end of a row are always 0.
+ */
+class BitGrid
+{
+    int32 width;
+    int32 height;
+    int32 stride;                // Words per row.
+    std::vector<uint64_t> bits;
+    
+public:
+    BitGrid() : width(0), height(0), stride(0) {}
+    BitGrid(int32 Width, int32 Height) { Resize(Width, Height); }
+    
+    // Resize and clear the grid.
+    void Resize(int32 Width, int32 Height)
+    {
+        width = std::max(Width, 0);
+        height = std::max(Height, 0);
+        stride = (width + 63) >> 6;
+        bits.assign((size_t)stride * height, 0);
+    }
+    
+    void Clear() { std::fill(bits.begin(), bits.end(), 0); }
+    
+    int32 Width() const { return width; }
+    int32 Height() const { return height; }
+    int32 Stride() const { return stride; }
+    
+    bool InBounds(int32 x, int32 y) const { return (x >= 0) && (y >= 0) && (x < width) && (y < height); }
+    
+    bool Get(int32 x, int32 y) const { return (bits[(size_t)y * stride + (x >> 6)] >> (x & 63)) & 1; }
+    void Set(int32 x, int32 y) { bits[(size_t)y * stride + (x >> 6)] |= (uint64_t)1 << (x & 63); }
+    void Reset(int32 x, int32 y) { bits[(size_t)y * stride + (x >> 6)] &= ~((uint64_t)1 << (x & 63)); }
+    
+    uint64_t* Row(int32 y) { return &bits[(size_t)y * stride]; }
+    const uint64_t* Row(int32 y) const { return &bits[(size_t)y * stride]; }
+    
+    /**
+     * Set or clear every bit from (Left, Top) to (Right, Bottom) inclusive.
+     * The rectangle is clipped to the grid, whole words are written at once.
+     */
+    void Fill(int32 Left, int32 Top, int32 Right, int32 Bottom, bool Value)
+    {
+        Left = std::max(Left, 0);
+        Top = std::max(Top, 0);
+        Right = std::min(Right, width - 1);
+        Bottom = std::min(Bottom, height - 1);
+        if(Left > Right || Top > Bottom) return;
+        
+        int32 firstWord = Left >> 6;
+        int32 lastWord = Right >> 6;
+        uint64_t firstMask = ~(uint64_t)0 << (Left & 63);
+        uint64_t lastMask = ~(uint64_t)0 >> (63 - (Right & 63));
+        
+        for(int32 y = Top; y <= Bottom; y++)
+        {
+            uint64_t* row = Row(y);
+            for(int32 w = firstWord; w <= lastWord; w++)
+            {
+                uint64_t mask = ~(uint64_t)0;
+                if(w == firstWord) mask &= firstMask;
+                if(w == lastWord) mask &= lastMask;
+                
+                if(Value)
+                {
+                    row[w] |= mask;
+                }
+                else
+                {
+                    row[w] &= ~mask;
+                }
+            }
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "Boruvka.h"
+#include "Kruskal.h"
+#include "UnionFind.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+
+using namespace std;
+
+static const uint64_t NoEdge = UINT64_MAX;
+
+// Lower the value held in target to value if it is smaller.
+static void atomicMin(atomic<uint64_t>& target, uint64_t value)
+{
+    uint64_t current = target.load(memory_order_relaxed);
+    while(value < current)
+    {
+        if(target.compare_exchange_weak(current, value, memory_order_relaxed))
+        {
+            break;
+        }
+    }
+}
+
+list<int32>* Boruvka::runBoruvka(vector<FPoint*>& vertices, vector<Edge*>& edges, int32 threads)
+{
+    list<int32>* finalEdge = new list<int32>();
+
+    int32 nVerts = vertices.size();
+    int32 nEdges = edges.size();
+    if(threads <= 0) threads = Parallel::ThreadCount();
+
+    // Rank every edge by (distance, index), packed so a single integer compare orders them.
+    vector<uint64_t> rank(nEdges);
+    Parallel::For(0, nEdges, [&](int32 begin, int32 end, int32)
+    {
+        for(int32 i = begin; i < end; i++)
+        {
+            int32 distance = Kruskal::metric_dist(*vertices[edges[i]->s], *vertices[edges[i]->t]);
+            rank[i] = ((uint64_t)(uint32_t)distance << 32) | (uint32_t)i;
+        }
+    }, threads);
+
+    ConcurrentUnionFind forest(nVerts);
+    vector<atomic<uint64_t> > cheapest(nVerts);
+    for(int32 i = 0; i < nVerts; i++)
+    {
+        cheapest[i].store(NoEdge, memory_order_relaxed);
+    }
+
+    vector<bool> inTree(nEdges, false);
+    vector<uint8_t> selected(nEdges, 0);
+
+    // Edges still joining two different components, shrinks every round.
+    vector<int32> live(nEdges);
+    for(int32 i = 0; i < nEdges; i++)
+    {
+        live[i] = i;
+    }
+
+    vector<vector<int32> > stillLive(threads);
+    bool linked = true;
+
+    while(linked && !live.empty())
+    {
+        // Find the cheapest edge leaving each component, dropping edges that are now internal.
+        // Fewer blocks than threads run once few edges are left, so clear every buffer, not just those used.
+        int32 nLive = live.size();
+        for(int32 t = 0; t < threads; t++)
+        {
+            stillLive[t].clear();
+        }
+        Parallel::For(0, nLive, [&](int32 begin, int32 end, int32 t)
+        {
+            vector<int32>& keep = stillLive[t];
+            for(int32 i = begin; i < end; i++)
+            {
+                int32 e = live[i];
+                int32 u = forest.find(edges[e]->s);
+                int32 v = forest.find(edges[e]->t);
+                if(u == v) continue;
+
+                keep.push_back(e);
+                atomicMin(cheapest[u], rank[e]);
+                atomicMin(cheapest[v], rank[e]);
+            }
+        }, threads);
+
+        // Blocks are handed out in order so this keeps live sorted by index.
+        live.clear();
+        for(int32 t = 0; t < threads; t++)
+        {
+            live.insert(live.end(), stillLive[t].begin(), stillLive[t].end());
+        }
+
+        // Contract every component along its cheapest edge.
+        atomic<bool> anyLinked(false);
+        Parallel::For(0, nVerts, [&](int32 begin, int32 end, int32)
+        {
+            bool found = false;
+            for(int32 i = begin; i < end; i++)
+            {
+                uint64_t best = cheapest[i].load(memory_order_relaxed);
+                if(best == NoEdge) continue;
+
+                cheapest[i].store(NoEdge, memory_order_relaxed);
+                int32 e = (int32)(best & 0xFFFFFFFFu);
+
+                // Both components may pick the same edge, only the successful link records it.
+                if(forest.link(edges[e]->s, edges[e]->t))
+                {
+                    selected[e] = 1;
+                    found = true;
+                }
+            }
+            if(found) anyLinked.store(true, memory_order_relaxed);
+        }, threads);
+
+        linked = anyLinked.load();
+    }
+
+    // Report the tree in the same order Kruskal would have found it.
+    vector<uint64_t> treeRank;
+    for(int32 i = 0; i < nEdges; i++)
+    {
+        if(selected[i])
+        {
+            inTree[i] = true;
+            treeRank.push_back(rank[i]);
+        }
+    }
+    sort(treeRank.begin(), treeRank.end());
+
+    for(uint64_t r : treeRank)
+    {
+        Edge* e = edges[(int32)(r & 0xFFFFFFFFu)];
+        finalEdge->push_back(e->s);
+        finalEdge->push_back(e->t);
+    }
+
+    // Remove used edges from edge list.
+    Kruskal::removeEdges(edges, inTree);
+
+    return finalEdge;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <list>
+#include "Delaunay.h"
+#include "FPoint.h"
+#include "Helper.h"
+
+/**
+ * A parallel implementation of Boruvka's algorithm to find the minimum spanning tree of a graph.
+ *
+ * Each round every component picks its cheapest outgoing edge, the edges are scanned by
+ * several threads at once and the winners are contracted through a concurrent union find.
+ * The number of components at least halves every round, so only O(log V) rounds are needed.
+ *
+ * Edges are ranked by (distance, edge index), the same order Kruskal uses, so the resulting
+ * tree is identical to Kruskal's output including the order of the returned edges.
+ *
+ * Input and output match Kruskal::runKruskal, the edges used in the tree are removed from edges.
+ */
+class Boruvka
+{
+public:
+    /** Vertex count from which CalcMinSpan prefers Boruvka over Kruskal. **/
+    static const int32 MinParallelVertices = 4096;
+
+    static std::list<int32>* runBoruvka(std::vector<FPoint*>& vertices, std::vector<Edge*>& edges, int32 threads = 0);
+};
\ No newline at end of file
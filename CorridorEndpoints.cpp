@@ -0,0 +1,79 @@
+#include "CorridorEndpoints.h"
+#include <cmath>
+#include <cstdlib>
+
+void CorridorEndpoints::Resize(int32 Count)
+{
+    CX.resize(Count);
+    CY.resize(Count);
+    HW.resize(Count);
+    HH.resize(Count);
+    Left.resize(Count);
+    Right.resize(Count);
+    Top.resize(Count);
+    Bottom.resize(Count);
+    DX.resize(Count);
+    DY.resize(Count);
+    OutX.resize(Count);
+    OutY.resize(Count);
+}
+
+void CorridorEndpoints::Set(int32 i, const IRect& room, const IRect& other)
+{
+    CX[i] = room.CenterX();
+    CY[i] = room.CenterY();
+    HW[i] = room.HalfWidth();
+    HH[i] = room.HalfHeight();
+    Left[i] = room.Left();
+    Right[i] = room.Right();
+    Top[i] = room.Top();
+    Bottom[i] = room.Bottom();
+    DX[i] = other.CenterX() - CX[i];
+    DY[i] = other.CenterY() - CY[i];
+}
+
+// Restrict tells the compiler the arrays never overlap, so it needs no runtime alias checks.
+static void SolveBatch(int32 n, const int32* __restrict cx, const int32* __restrict cy, const int32* __restrict hw, const int32* __restrict hh,
+                       const int32* __restrict left, const int32* __restrict right, const int32* __restrict top, const int32* __restrict bottom,
+                       const int32* __restrict dx, const int32* __restrict dy, int32* __restrict outX, int32* __restrict outY)
+{
+    for(int32 i = 0; i < n; i++)
+    {
+        int32 ix = dx[i];
+        int32 iy = dy[i];
+        int32 ax = std::abs(ix);
+        int32 ay = std::abs(iy);
+        
+        // Choices are made with all ones / all zeros masks so every lane does the same work.
+        // Leaves through the left or right side when the ray is no steeper than the corner diagonal,
+        // products of integers well below 2^26 are exact in a double.
+        int32 side = -(int32)(((double)ay * hw[i]) <= ((double)ax * hh[i]));
+        
+        // Offset along the side it crosses: halfWidth * dy / |dx| or halfHeight * dx / |dy|.
+        int32 half = (hw[i] & side) | (hh[i] & ~side);
+        int32 offset = (iy & side) | (ix & ~side);
+        int32 den = (ax & side) | (ay & ~side);
+        int32 base = (cy[i] & side) | (cx[i] & ~side);
+        
+        // den is only 0 when half * offset is 0 too, dividing by 1 then leaves it alone.
+        double v = base + ((double)half * offset) / (double)(den + (den == 0));
+        
+        // Round half away from zero, as round() does, the conversion truncates towards zero.
+        int32 along = (int32)(v + std::copysign(0.5, v));
+        
+        // A vertical ray through a zero width room still counts as leaving to the right.
+        int32 toRight = -(int32)((ix > 0) | ((ix == 0) & (iy != 0)));
+        int32 up = -(int32)(iy < 0);
+        int32 sideX = (right[i] & toRight) | (left[i] & ~toRight);
+        int32 sideY = (top[i] & up) | (bottom[i] & ~up);
+        
+        outX[i] = (sideX & side) | (along & ~side);
+        outY[i] = (along & side) | (sideY & ~side);
+    }
+}
+
+void CorridorEndpoints::Solve()
+{
+    SolveBatch(Size(), CX.data(), CY.data(), HW.data(), HH.data(), Left.data(), Right.data(), Top.data(), Bottom.data(),
+               DX.data(), DY.data(), OutX.data(), OutY.data());
+}
\ No newline at end of file
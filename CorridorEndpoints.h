@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include "IRect.h"
+#include "Helper.h"
+
+/**
+ * Finds where a corridor leaves a room, for many corridor ends at once.
+ *
+ * A ray from the room centre towards the centre of the room at the other end
+ * of the corridor is clipped against the room box (a slab test). The side it
+ * leaves through is chosen by comparing |dy| * halfWidth with |dx| * halfHeight,
+ * which is exact on integer centres, and the position along that side is the
+ * centre plus the ray offset rounded half away from zero. No trigonometry is used.
+ *
+ * Data is held as a structure of arrays and Solve is a single branch free loop,
+ * so the compiler can run it across SIMD lanes on any target.
+ */
+class CorridorEndpoints
+{
+public:
+    std::vector<int32> CX, CY;            // Room centre.
+    std::vector<int32> HW, HH;            // Room half width and half height.
+    std::vector<int32> Left, Right;
+    std::vector<int32> Top, Bottom;
+    std::vector<int32> DX, DY;            // Direction towards the other room's centre.
+    std::vector<int32> OutX, OutY;        // Point where the corridor meets the room.
+    
+    CorridorEndpoints(int32 Count = 0) { Resize(Count); }
+    
+    int32 Size() const { return CX.size(); }
+    void Resize(int32 Count);
+    
+    // Fill entry i with the end of a corridor leaving room towards other.
+    void Set(int32 i, const IRect& room, const IRect& other);
+    
+    // Compute OutX, OutY for every entry.
+    void Solve();
+};
\ No newline at end of file
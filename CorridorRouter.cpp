@@ -0,0 +1,520 @@
+#include "CorridorRouter.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+static const uint8_t NoDir = 0xFF;
+static const int32 StepX[4] = { 1, 0, -1, 0 };
+static const int32 StepY[4] = { 0, 1, 0, -1 };
+
+// Window holds cells from Left() up to but not including Right(), likewise vertically.
+static inline bool inWindow(const IRect& Window, int32 x, int32 y)
+{
+    return (x >= Window.Left()) && (y >= Window.Top()) && (x < Window.Right()) && (y < Window.Bottom());
+}
+
+// Heap order for the open list, lowest F first and on a tie lowest H.
+static bool openAfter(const RouteWorkspace::OpenNode& a, const RouteWorkspace::OpenNode& b)
+{
+    return (a.F > b.F) || ((a.F == b.F) && (a.H > b.H));
+}
+
+void RouteWorkspace::Begin(int32 Cells)
+{
+    // Only ever grows, so A* and jump point searches can share a workspace.
+    if((int32)G.size() < Cells)
+    {
+        G.resize(Cells);
+        Dir.resize(Cells);
+        Stamp.assign(Cells, 0);
+        Search = 0;
+    }
+    
+    // Stamps only need clearing when the counter wraps.
+    if(++Search == 0)
+    {
+        fill(Stamp.begin(), Stamp.end(), 0);
+        Search = 1;
+    }
+    
+    Open.clear();
+    Expansions = 0;
+}
+
+CorridorRouter::CorridorRouter(MapInfoType& MapInfo)
+{
+    width = MapInfo.Width;
+    height = MapInfo.Height;
+    blocked.Resize(width, height);
+    corridors.Resize(width, height);
+    
+    // Room walls are blocked too, corridors may only end on them.
+    int32 len = MapInfo.Rooms.size();
+    for(int32 i = 0; i < len; i++)
+    {
+        const IRect& r = MapInfo.Rooms[i]->Bounds;
+        blocked.Fill(r.Left(), r.Top(), r.Right(), r.Bottom(), true);
+    }
+    
+    len = MapInfo.Corridors.size();
+    for(int32 i = 0; i < len; i++)
+    {
+        MarkPath(MapInfo.Corridors[i]->Path);
+    }
+}
+
+bool CorridorRouter::Route(const IPoint& Start, const IPoint& End, vector<IPoint>& Path, RouteWorkspace& Work) const
+{
+    return Search(Start, End, Path, Work, false);
+}
+
+bool CorridorRouter::RouteJumpPoint(const IPoint& Start, const IPoint& End, vector<IPoint>& Path, RouteWorkspace& Work) const
+{
+    return Search(Start, End, Path, Work, true);
+}
+
+bool CorridorRouter::Search(const IPoint& Start, const IPoint& End, vector<IPoint>& Path, RouteWorkspace& Work, bool JumpPoint) const
+{
+    if(!blocked.InBounds(Start.X, Start.Y) || !blocked.InBounds(End.X, End.Y))
+    {
+        return false;
+    }
+    
+    // Most routes stay close to the box around their ends, so search a window around it
+    // and only widen it when there is no route inside. This keeps the workspace small.
+    int32 margin = MinWindowMargin + max(abs(End.X - Start.X), abs(End.Y - Start.Y)) / 2;
+    int32 expansions = 0;
+    while(true)
+    {
+        int32 left = max(min(Start.X, End.X) - margin, 0);
+        int32 top = max(min(Start.Y, End.Y) - margin, 0);
+        int32 right = min(max(Start.X, End.X) + margin + 1, width);
+        int32 bottom = min(max(Start.Y, End.Y) + margin + 1, height);
+        IRect window(left, top, right - left, bottom - top);
+        
+        bool found = JumpPoint ? JumpPointIn(window, Start, End, Path, Work) : AStarIn(window, Start, End, Path, Work);
+        expansions += Work.Expansions;
+        
+        if(found || (left == 0 && top == 0 && right == width && bottom == height))
+        {
+            Work.Expansions = expansions;
+            return found;
+        }
+        margin *= 2;
+    }
+}
+
+bool CorridorRouter::AStarIn(const IRect& Window, const IPoint& Start, const IPoint& End, vector<IPoint>& Path, RouteWorkspace& Work) const
+{
+    // Cells are numbered within the window.
+    int32 stride = Window.Width;
+    int32 originX = Window.Left();
+    int32 originY = Window.Top();
+    int32 start = (Start.Y - originY) * stride + (Start.X - originX);
+    int32 goal = (End.Y - originY) * stride + (End.X - originX);
+    
+    // A state is a cell and the axis it was entered along, cell * 2 + (0 across, 1 down),
+    // so the cost of the next turn is known exactly. The start may leave along either axis.
+    Work.Begin(stride * Window.Height * 2);
+    uint32_t search = Work.Search;
+    
+    for(int32 axis = 0; axis < 2; axis++)
+    {
+        Work.G[start * 2 + axis] = 0;
+        Work.Stamp[start * 2 + axis] = search;
+        Work.Dir[start * 2 + axis] = NoDir;
+        
+        RouteWorkspace::OpenNode origin = { 0, 0, start * 2 + axis };
+        Work.Open.push_back(origin);
+    }
+    
+    int32 found = -1;
+    while(!Work.Open.empty())
+    {
+        pop_heap(Work.Open.begin(), Work.Open.end(), openAfter);
+        RouteWorkspace::OpenNode node = Work.Open.back();
+        Work.Open.pop_back();
+        
+        // Skip entries left behind when a cheaper route to the state was found.
+        int32 state = node.Cell;
+        uint32_t g = node.F - node.H;
+        if(g != Work.G[state]) continue;
+        
+        Work.Expansions++;
+        
+        int32 cell = state >> 1;
+        if(cell == goal)
+        {
+            found = state;
+            break;
+        }
+        
+        int32 x = originX + cell % stride;
+        int32 y = originY + cell / stride;
+        bool turnFree = (Work.Dir[state] == NoDir);
+        
+        for(uint8_t d = 0; d < 4; d++)
+        {
+            int32 nx = x + StepX[d];
+            int32 ny = y + StepY[d];
+            if(!inWindow(Window, nx, ny)) continue;
+            
+            int32 nextCell = (ny - originY) * stride + (nx - originX);
+            if(nextCell != goal && blocked.Get(nx, ny)) continue;
+            
+            uint32_t cost = g + (corridors.Get(nx, ny) ? ReuseCost : StepCost);
+            if(!turnFree && (d & 1) != (state & 1)) cost += TurnCost;
+            
+            int32 next = nextCell * 2 + (d & 1);
+            if(Work.Stamp[next] == search && Work.G[next] <= cost) continue;
+            
+            // Dir holds the step taken and, in bit 2, the axis of the state it came from.
+            Work.Stamp[next] = search;
+            Work.G[next] = cost;
+            Work.Dir[next] = d | ((state & 1) << 2);
+            
+            // Manhattan distance at the normal step cost, plus a turn when the goal is off
+            // the line being followed. It overestimates where a route could reuse a
+            // corridor, which gives up a little sharing for far fewer expansions.
+            uint32_t h = (abs(End.X - nx) + abs(End.Y - ny)) * StepCost;
+            if((d & 1) ? (nx != End.X) : (ny != End.Y)) h += TurnCost;
+            RouteWorkspace::OpenNode open = { cost + h, h, next };
+            Work.Open.push_back(open);
+            push_heap(Work.Open.begin(), Work.Open.end(), openAfter);
+        }
+    }
+    
+    if(found == -1)
+    {
+        return false;
+    }
+    
+    // Walk back from the goal keeping only the cells where the axis changes.
+    size_t first = Path.size();
+    Path.push_back(End);
+    
+    int32 state = found;
+    while(Work.Dir[state] != NoDir)
+    {
+        uint8_t d = Work.Dir[state] & 3;
+        int32 prevCell = (state >> 1) - StepY[d] * stride - StepX[d];
+        int32 prev = prevCell * 2 + ((Work.Dir[state] >> 2) & 1);
+        if(Work.Dir[prev] != NoDir && (prev & 1) != (state & 1))
+        {
+            Path.push_back(IPoint(originX + prevCell % stride, originY + prevCell / stride));
+        }
+        state = prev;
+    }
+    
+    Path.push_back(Start);
+    reverse(Path.begin() + first, Path.end());
+    return true;
+}
+
+/**
+ * The blocked grid as jump point search sees it: the goal is open, even on a wall,
+ * and everything outside the search window is blocked.
+ */
+class JumpGrid
+{
+    const BitGrid& grid;
+    int32 goalX, goalY;
+    int32 left, top, right, bottom;    // Window, right and bottom exclusive.
+    
+public:
+    JumpGrid(const BitGrid& Grid, const IPoint& Goal, const IRect& Window) : grid(Grid), goalX(Goal.X), goalY(Goal.Y)
+    {
+        left = Window.Left();
+        top = Window.Top();
+        right = Window.Right();
+        bottom = Window.Bottom();
+    }
+    
+    uint64_t Word(int32 y, int32 w) const
+    {
+        if(y < top || y >= bottom || w < (left >> 6) || w > ((right - 1) >> 6)) return ~(uint64_t)0;
+        
+        uint64_t bits = grid.Row(y)[w];
+        int32 first = w << 6;
+        if(first < left) bits |= ~(uint64_t)0 >> (64 - (left - first));
+        if(first + 64 > right) bits |= ~(uint64_t)0 << (right - first);
+        if(y == goalY && w == (goalX >> 6)) bits &= ~((uint64_t)1 << (goalX & 63));
+        return bits;
+    }
+    
+    bool Blocked(int32 x, int32 y) const
+    {
+        if(x < left || x >= right) return true;
+        return (Word(y, x >> 6) >> (x & 63)) & 1;
+    }
+    
+    /**
+     * Scan along row y from x in direction dx for the first jump point: the goal, or a
+     * cell with an open cell above or below whose neighbour behind is blocked, so the
+     * route may have to turn there. Returns its x, or -1 if a wall comes first.
+     */
+    int32 JumpX(int32 x, int32 y, int32 dx) const
+    {
+        x += dx;
+        if(x < left || x >= right) return -1;
+        
+        int32 w = x >> 6;
+        int32 goalWord = (y == goalY) ? (goalX >> 6) : -1;
+        
+        if(dx > 0)
+        {
+            uint64_t mask = ~(uint64_t)0 << (x & 63);
+            for(; w < grid.Stride(); w++, mask = ~(uint64_t)0)
+            {
+                uint64_t up = Word(y - 1, w);
+                uint64_t down = Word(y + 1, w);
+                
+                // Open cells whose left hand neighbour is blocked.
+                uint64_t turns = (~up & ((up << 1) | (Word(y - 1, w - 1) >> 63))) |
+                                 (~down & ((down << 1) | (Word(y + 1, w - 1) >> 63)));
+                if(w == goalWord) turns |= (uint64_t)1 << (goalX & 63);
+                
+                uint64_t stop = Word(y, w) & mask;
+                uint64_t hit = turns & mask & ~stop;
+                if(hit && (!stop || LowestBit(hit) < LowestBit(stop))) return (w << 6) + LowestBit(hit);
+                if(stop) return -1;
+            }
+        }
+        else
+        {
+            uint64_t mask = ~(uint64_t)0 >> (63 - (x & 63));
+            for(; w >= 0; w--, mask = ~(uint64_t)0)
+            {
+                uint64_t up = Word(y - 1, w);
+                uint64_t down = Word(y + 1, w);
+                
+                // Open cells whose right hand neighbour is blocked.
+                uint64_t turns = (~up & ((up >> 1) | (Word(y - 1, w + 1) << 63))) |
+                                 (~down & ((down >> 1) | (Word(y + 1, w + 1) << 63)));
+                if(w == goalWord) turns |= (uint64_t)1 << (goalX & 63);
+                
+                uint64_t stop = Word(y, w) & mask;
+                uint64_t hit = turns & mask & ~stop;
+                if(hit && (!stop || HighestBit(hit) > HighestBit(stop))) return (w << 6) + HighestBit(hit);
+                if(stop) return -1;
+            }
+        }
+        return -1;
+    }
+    
+    /**
+     * Step along column x from y in direction dy. A cell is a jump point if it is the
+     * goal or a scan left or right from it finds one. Returns its y or -1.
+     */
+    int32 JumpY(int32 x, int32 y, int32 dy) const
+    {
+        for(y += dy; !Blocked(x, y); y += dy)
+        {
+            if((x == goalX && y == goalY) || JumpX(x, y, 1) != -1 || JumpX(x, y, -1) != -1)
+            {
+                return y;
+            }
+        }
+        return -1;
+    }
+};
+
+bool CorridorRouter::JumpPointIn(const IRect& Window, const IPoint& Start, const IPoint& End, vector<IPoint>& Path, RouteWorkspace& Work) const
+{
+    JumpGrid grid(blocked, End, Window);
+    int32 stride = Window.Width;
+    int32 originX = Window.Left();
+    int32 originY = Window.Top();
+    int32 start = (Start.Y - originY) * stride + (Start.X - originX);
+    int32 goal = (End.Y - originY) * stride + (End.X - originX);
+    
+    Work.Begin(stride * Window.Height);
+    uint32_t search = Work.Search;
+    
+    Work.G[start] = 0;
+    Work.Stamp[start] = search;
+    Work.Dir[start] = NoDir;
+    
+    RouteWorkspace::OpenNode origin = { 0, 0, start };
+    Work.Open.push_back(origin);
+    
+    while(!Work.Open.empty())
+    {
+        pop_heap(Work.Open.begin(), Work.Open.end(), openAfter);
+        RouteWorkspace::OpenNode node = Work.Open.back();
+        Work.Open.pop_back();
+        
+        int32 cell = node.Cell;
+        uint32_t g = node.F - node.H;
+        if(g != Work.G[cell]) continue;
+        
+        Work.Expansions++;
+        if(cell == goal) break;
+        
+        int32 x = originX + cell % stride;
+        int32 y = originY + cell / stride;
+        uint8_t from = Work.Dir[cell];
+        
+        for(uint8_t d = 0; d < 4; d++)
+        {
+            if(from != NoDir && d == ((from + 2) & 3)) continue;
+            
+            // After a horizontal move only carry on, or turn where the wall behind ends.
+            // After a vertical move carry on or turn either way.
+            if(from != NoDir && StepY[from] == 0 && d != from)
+            {
+                if(grid.Blocked(x, y + StepY[d]) || !grid.Blocked(x - StepX[from], y + StepY[d])) continue;
+            }
+            
+            int32 nx = x;
+            int32 ny = y;
+            if(StepX[d] != 0)
+            {
+                nx = grid.JumpX(x, y, StepX[d]);
+                if(nx == -1) continue;
+            }
+            else
+            {
+                ny = grid.JumpY(x, y, StepY[d]);
+                if(ny == -1) continue;
+            }
+            
+            int32 next = (ny - originY) * stride + (nx - originX);
+            uint32_t cost = g + (abs(nx - x) + abs(ny - y)) * StepCost;
+            if(Work.Stamp[next] == search && Work.G[next] <= cost) continue;
+            
+            Work.Stamp[next] = search;
+            Work.G[next] = cost;
+            Work.Dir[next] = d;
+            
+            uint32_t h = (abs(End.X - nx) + abs(End.Y - ny)) * StepCost;
+            RouteWorkspace::OpenNode open = { cost + h, h, next };
+            Work.Open.push_back(open);
+            push_heap(Work.Open.begin(), Work.Open.end(), openAfter);
+        }
+    }
+    
+    if(Work.Stamp[goal] != search)
+    {
+        return false;
+    }
+    
+    // Jump points in a straight line are merged, leaving only the corners.
+    size_t first = Path.size();
+    Path.push_back(End);
+    
+    int32 cell = goal;
+    while(cell != start)
+    {
+        // The jump point it came from is the nearest one back along its direction whose cost fits.
+        uint8_t d = Work.Dir[cell];
+        int32 step = StepY[d] * stride + StepX[d];
+        int32 prev = cell - step;
+        uint32_t cost = StepCost;
+        while(Work.Stamp[prev] != search || Work.G[prev] + cost != Work.G[cell])
+        {
+            prev -= step;
+            cost += StepCost;
+        }
+        
+        if(prev != start && Work.Dir[prev] != d)
+        {
+            Path.push_back(IPoint(originX + prev % stride, originY + prev / stride));
+        }
+        cell = prev;
+    }
+    
+    Path.push_back(Start);
+    reverse(Path.begin() + first, Path.end());
+    return true;
+}
+
+void CorridorRouter::MarkPath(const vector<IPoint>& Path)
+{
+    int32 len = Path.size();
+    for(int32 i = 1; i < len; i++)
+    {
+        const IPoint& a = Path[i - 1];
+        const IPoint& b = Path[i];
+        
+        // Routed paths are axis aligned, a diagonal straight corridor is left out.
+        if(a.X != b.X && a.Y != b.Y) continue;
+        corridors.Fill(min(a.X, b.X), min(a.Y, b.Y), max(a.X, b.X), max(a.Y, b.Y), true);
+    }
+}
+
+// True if a cell of Path, other than its two ends, is already corridor.
+bool CorridorRouter::Overlaps(const vector<IPoint>& Path) const
+{
+    int32 len = Path.size();
+    for(int32 i = 1; i < len; i++)
+    {
+        IPoint a = Path[i - 1];
+        const IPoint& b = Path[i];
+        if(a.X != b.X && a.Y != b.Y) continue;
+        
+        int32 dx = (b.X > a.X) - (b.X < a.X);
+        int32 dy = (b.Y > a.Y) - (b.Y < a.Y);
+        while(a.X != b.X || a.Y != b.Y)
+        {
+            a.X += dx;
+            a.Y += dy;
+            if(i == len - 1 && a.X == b.X && a.Y == b.Y) break;
+            if(corridors.InBounds(a.X, a.Y) && corridors.Get(a.X, a.Y)) return true;
+        }
+    }
+    return false;
+}
+
+int32 CorridorRouter::ResolveOverlaps(vector<Corridor*>& Corridors, int32 First, RouteWorkspace& Work, CorridorRouting Routing)
+{
+    int32 rerouted = 0;
+    int32 len = Corridors.size();
+    for(int32 i = First; i < len; i++)
+    {
+        Corridor& c = *Corridors[i];
+        
+        // Jump point routes ignore other corridors, routing again would change nothing.
+        if(Routing == AStarRouting && Overlaps(c.Path))
+        {
+            RouteCorridor(c, Work, Routing, true);
+            rerouted++;
+        }
+        else
+        {
+            MarkPath(c.Path);
+        }
+    }
+    return rerouted;
+}
+
+void CorridorRouter::RouteCorridor(Corridor& c, RouteWorkspace& Work, CorridorRouting Routing, bool Mark)
+{
+    IPoint start(c.SX, c.SY);
+    IPoint end(c.EX, c.EY);
+    
+    vector<IPoint> path;
+    bool routed = false;
+    if(Routing == AStarRouting)
+    {
+        routed = Route(start, end, path, Work);
+    }
+    else if(Routing == JumpPointRouting)
+    {
+        routed = RouteJumpPoint(start, end, path, Work);
+    }
+    if(!routed)
+    {
+        path.push_back(start);
+        path.push_back(end);
+    }
+    
+    c.Path.swap(path);
+    c.UpdateBounds();
+    
+    if(routed && Mark)
+    {
+        MarkPath(c.Path);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "BitGrid.h"
+#include "IPoint.h"
+#include "MapModel.h"
+#include "Helper.h"
+
+/** How GenerateCorridors lays out each corridor. **/
+enum CorridorRouting
+{
+    StraightRouting,    /** A single segment between the two room walls. **/
+    AStarRouting,       /** Grid A* around the rooms, preferring L shapes and existing corridors. **/
+    JumpPointRouting    /** Jump point search around the rooms, every step costs the same. **/
+};
+
+/**
+ * Search state for CorridorRouter, kept between routes so each search reuses
+ * the same memory. Cells are only valid when their stamp matches the current
+ * search, so nothing has to be cleared between routes.
+ */
+class RouteWorkspace
+{
+public:
+    typedef struct
+    {
+        uint32_t F;     // Cost so far plus estimate.
+        uint32_t H;     // Estimate, ties on F go to the node nearer the goal.
+        int32 Cell;
+    } OpenNode;
+    
+    std::vector<uint32_t> G;       // Cheapest cost found to each search state.
+    std::vector<uint32_t> Stamp;   // Search that last wrote G and Dir.
+    std::vector<uint8_t> Dir;      // Step each state was entered by.
+    std::vector<OpenNode> Open;    // Binary heap.
+    uint32_t Search;
+    int32 Expansions;              // Nodes taken off the open list by the last route.
+    
+    RouteWorkspace() : Search(0), Expansions(0) {}
+    
+    // Make room for Cells search states and start a new search.
+    void Begin(int32 Cells);
+};
+
+/**
+ * Routes corridors between room walls on a grid the size of the map.
+ *
+ * Rooms are rasterised into a bit packed occupancy grid, walls included, and
+ * each corridor is found with A* over 4 connected cells. Every step costs
+ * StepCost, or ReuseCost on a cell an earlier corridor already uses, and each
+ * change of direction adds TurnCost, so routes come out as L shapes where
+ * possible and merge into existing corridors.
+ */
+class CorridorRouter
+{
+public:
+    static const uint32_t StepCost = 4;
+    static const uint32_t ReuseCost = 2;
+    static const uint32_t TurnCost = 8;
+    
+    CorridorRouter(MapInfoType& MapInfo);
+    
+    /**
+     * Find a route from Start to End and append it to Path as its corner points,
+     * both ends included. Start and End may sit on a room wall.
+     * The search starts in a window around the two ends and widens it until a route
+     * is found or the window covers the map.
+     * Returns false, leaving Path untouched, if either end is off the map or no route exists.
+     */
+    bool Route(const IPoint& Start, const IPoint& End, std::vector<IPoint>& Path, RouteWorkspace& Work) const;
+    
+    /**
+     * As Route, but with jump point search. Only jump points, where a route may have to
+     * turn, go on the open list, and runs of free cells are skipped a word at a time.
+     * Reuse and turn costs are ignored, of the shortest routes it returns one that
+     * makes its vertical moves first, which keeps it to few turns.
+     */
+    bool RouteJumpPoint(const IPoint& Start, const IPoint& End, std::vector<IPoint>& Path, RouteWorkspace& Work) const;
+    
+    /** Record the cells of Path as corridor so later routes prefer to share them. **/
+    void MarkPath(const std::vector<IPoint>& Path);
+    
+    /** Route c between its end points, falling back to a straight line, and set its Path and Bounds. **/
+    void RouteCorridor(Corridor& c, RouteWorkspace& Work, CorridorRouting Routing = AStarRouting, bool Mark = true);
+    
+    /**
+     * Settle Corridors[First..] after they were routed without seeing each other, in order.
+     * An A* corridor that runs over one before it is routed again so it can merge
+     * into it, the rest are kept. Each one is marked before the next is looked at,
+     * so the result only depends on the order of the corridors.
+     * Returns the number routed again.
+     */
+    int32 ResolveOverlaps(std::vector<Corridor*>& Corridors, int32 First, RouteWorkspace& Work, CorridorRouting Routing);
+    
+    const BitGrid& Blocked() const { return blocked; }
+    const BitGrid& Corridors() const { return corridors; }
+    
+private:
+    static const int32 MinWindowMargin = 32;
+    
+    int32 width;
+    int32 height;
+    BitGrid blocked;
+    BitGrid corridors;
+    
+    bool Overlaps(const std::vector<IPoint>& Path) const;
+    bool Search(const IPoint& Start, const IPoint& End, std::vector<IPoint>& Path, RouteWorkspace& Work, bool JumpPoint) const;
+    bool AStarIn(const IRect& Window, const IPoint& Start, const IPoint& End, std::vector<IPoint>& Path, RouteWorkspace& Work) const;
+    bool JumpPointIn(const IRect& Window, const IPoint& Start, const IPoint& End, std::vector<IPoint>& Path, RouteWorkspace& Work) const;
+};
\ No newline at end of file
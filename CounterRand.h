@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include "Helper.h"
+
+/** The stages of the pipeline that draw random numbers, each from its own stream of the map seed. **/
+enum RandomStream
+{
+    RoomStream,         /** Position and size of each room made. **/
+    ReduceStream,       /** Rooms removed to get down to MaxRooms. **/
+    RandomEdgeStream,   /** Extra corridors added to the spanning tree. **/
+    PointStream         /** Test points for the triangulation. **/
+};
+
+/** SplitMix64 finaliser, spreads nearby inputs over the whole range. **/
+static inline uint64_t Mix64(uint64_t v)
+{
+    v += 0x9E3779B97F4A7C15ULL;
+    v = (v ^ (v >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    v = (v ^ (v >> 27)) * 0x94D049BB133111EBULL;
+    return v ^ (v >> 31);
+}
+
+/**
+ * Counter based random numbers: the n-th value of a stream is a hash of the
+ * stream's key and n, with no state carried from one value to the next.
+ *
+ * The key comes from a seed and a stream id, so every stage of a map draws
+ * from its own stream and adding draws to one stage leaves the others alone.
+ * Any value can be reached directly with Seek, so a range of work can be
+ * split between threads, each starting at the counter its first item would
+ * have had, and still give the same numbers as a single thread.
+ *
+ * The values are SplitMix64 outputs, with the key as the starting state.
+ */
+class CounterRand
+{
+public:
+    CounterRand(uint64_t Seed, uint64_t Stream, uint64_t Counter = 0) : key(Mix64(Mix64(Seed) ^ Stream)), counter(Counter) {}
+    
+    /** Value Counter of the stream, whatever the current counter. **/
+    uint64_t At(uint64_t Counter) const { return Mix64(key + Counter * 0x9E3779B97F4A7C15ULL); }
+    
+    uint64_t Next() { return At(counter++); }
+    uint32_t Next32() { return (uint32_t)(Next() >> 32); }
+    
+    /** Uniform in [0, 1), 53 bits. **/
+    double NextDouble() { return (Next() >> 11) * (1.0 / 9007199254740992.0); }
+    
+    /** Uniform in [0, N), 0 when N is 0. Multiply and shift rather than modulo, biased by at most N / 2^32. **/
+    uint32_t Below(uint32_t N) { return (uint32_t)(((uint64_t)Next32() * N) >> 32); }
+    
+    /** Uniform in [Min, Max], both included. **/
+    int32 Range(int32 Min, int32 Max) { return Min + (int32)Below((uint32_t)(Max - Min) + 1); }
+    
+    /** Move to value Counter, or N values on, without drawing the ones between. **/
+    void Seek(uint64_t Counter) { counter = Counter; }
+    void Skip(uint64_t N) { counter += N; }
+    uint64_t Counter() const { return counter; }
+    
+private:
+    uint64_t key;
+    uint64_t counter;
+};
\ No newline at end of file
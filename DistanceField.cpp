@@ -0,0 +1,245 @@
+#include "DistanceField.h"
+#include "Parallel.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+const uint16_t DistanceField::Unreachable;
+const uint16_t DistanceField::MaxDistance;
+
+// Rings with fewer tiles than this are expanded by one thread.
+static const size_t MinParallelRing = 4096;
+
+static const int32 stepX[4] = { 0, 1, 0, -1 };
+static const int32 stepY[4] = { -1, 0, 1, 0 };
+
+// Can a walker on floor tile (x, y) step through Side, staying inside the grid.
+static inline bool canStep(const TileGrid& Tiles, int32 x, int32 y, int32 Side)
+{
+    return Tiles.Plane(FloorPlane).InBounds(x + stepX[Side], y + stepY[Side]) && !Tiles.Plane(BlockedPlane + Side).Get(x, y);
+}
+
+/** Threads meeting between rings of the search. The last to arrive runs Between before releasing the rest. **/
+class RingBarrier
+{
+public:
+    explicit RingBarrier(int32 Threads) : threads(Threads), waiting(0), generation(0) {}
+    
+    template<typename Fn>
+    void Wait(Fn Between)
+    {
+        unique_lock<mutex> guard(lock);
+        int32 current = generation;
+        if(++waiting == threads)
+        {
+            Between();
+            waiting = 0;
+            generation++;
+            release.notify_all();
+            return;
+        }
+        release.wait(guard, [&]() { return generation != current; });
+    }
+    
+private:
+    mutex lock;
+    condition_variable release;
+    int32 threads;
+    int32 waiting;
+    int32 generation;
+};
+
+void DistanceField::Start(const TileGrid& Tiles, const vector<IPoint>& Sources, vector<int32>& Frontier)
+{
+    width = Tiles.Width();
+    height = Tiles.Height();
+    distance.assign((size_t)width * height, Unreachable);
+    
+    Frontier.clear();
+    for(const IPoint& s : Sources)
+    {
+        if(s.X < 0 || s.Y < 0 || s.X >= width || s.Y >= height || !Tiles.IsFloor(s.X, s.Y)) continue;
+        
+        int32 i = s.Y * width + s.X;
+        if(distance[i] == 0) continue;
+        distance[i] = 0;
+        Frontier.push_back(i);
+    }
+}
+
+void DistanceField::Compute(const TileGrid& Tiles, const vector<IPoint>& Sources, int32 Threads)
+{
+    vector<int32> frontier;
+    Start(Tiles, Sources, frontier);
+    
+    if(Threads <= 0) Threads = Parallel::ThreadCount();
+    if(Threads == 1)
+    {
+        // Plain queue, the frontier vector is walked while it grows.
+        for(size_t q = 0; q < frontier.size(); q++)
+        {
+            int32 i = frontier[q];
+            int32 x = i % width;
+            int32 y = i / width;
+            uint16_t next = (uint16_t)min(distance[i] + 1, (int32)MaxDistance);
+            for(int32 side = TopWall; side <= LeftWall; side++)
+            {
+                if(!canStep(Tiles, x, y, side)) continue;
+                
+                int32 n = i + stepY[side] * width + stepX[side];
+                if(distance[n] != Unreachable) continue;
+                distance[n] = next;
+                frontier.push_back(n);
+            }
+        }
+        return;
+    }
+    
+    // One ring at a time. Each thread expands a slice of the ring, claiming tiles with an
+    // atomic bit so every tile joins the next ring exactly once.
+    vector<atomic<uint64_t>> claimed(((size_t)width * height + 63) / 64);
+    for(int32 i : frontier)
+    {
+        claimed[i >> 6].fetch_or((uint64_t)1 << (i & 63));
+    }
+    
+    uint16_t ring = 0;
+    auto expandSlice = [&](size_t Begin, size_t End, vector<int32>& Next)
+    {
+        uint16_t d = (uint16_t)min(ring + 1, (int32)MaxDistance);
+        for(size_t q = Begin; q < End; q++)
+        {
+            int32 i = frontier[q];
+            int32 x = i % width;
+            int32 y = i / width;
+            for(int32 side = TopWall; side <= LeftWall; side++)
+            {
+                if(!canStep(Tiles, x, y, side)) continue;
+                
+                int32 n = i + stepY[side] * width + stepX[side];
+                uint64_t bit = (uint64_t)1 << (n & 63);
+                if(claimed[n >> 6].load(memory_order_relaxed) & bit) continue;
+                if(claimed[n >> 6].fetch_or(bit) & bit) continue;
+                distance[n] = d;
+                Next.push_back(n);
+            }
+        }
+    };
+    
+    // Narrow rings, common along corridors, are not worth a meeting of every thread.
+    vector<vector<int32>> next(Threads);
+    auto expandNarrow = [&]()
+    {
+        while(!frontier.empty() && frontier.size() < MinParallelRing)
+        {
+            expandSlice(0, frontier.size(), next[0]);
+            frontier.swap(next[0]);
+            next[0].clear();
+            ring = (uint16_t)min(ring + 1, (int32)MaxDistance);
+        }
+    };
+    
+    expandNarrow();
+    RingBarrier barrier(Threads);
+    auto expand = [&](int32 t)
+    {
+        while(!frontier.empty())
+        {
+            expandSlice(frontier.size() * t / Threads, frontier.size() * (t + 1) / Threads, next[t]);
+            
+            // The last thread in gathers the next ring for everyone.
+            barrier.Wait([&]()
+            {
+                frontier.clear();
+                for(vector<int32>& n : next)
+                {
+                    frontier.insert(frontier.end(), n.begin(), n.end());
+                    n.clear();
+                }
+                ring = (uint16_t)min(ring + 1, (int32)MaxDistance);
+                expandNarrow();
+            });
+        }
+    };
+    
+    if(frontier.empty()) return;
+    
+    vector<thread> workers;
+    for(int32 t = 1; t < Threads; t++)
+    {
+        workers.push_back(thread(expand, t));
+    }
+    expand(0);
+    for(thread& w : workers)
+    {
+        w.join();
+    }
+}
+
+void DistanceField::Compute(const TileGrid& Tiles, const vector<IPoint>& Sources, const uint8_t* Costs)
+{
+    vector<int32> frontier;
+    Start(Tiles, Sources, frontier);
+    
+    // Costs are at most 255, so a ring of 256 buckets holds every distance still to settle.
+    vector<vector<int32>> buckets(256);
+    buckets[0] = frontier;
+    size_t pending = frontier.size();
+    for(uint32_t d = 0; pending > 0; d++)
+    {
+        vector<int32>& bucket = buckets[d & 255];
+        for(size_t q = 0; q < bucket.size(); q++)
+        {
+            int32 i = bucket[q];
+            pending--;
+            if(distance[i] != d) continue;    // Left over from before a cheaper path was found.
+            
+            int32 x = i % width;
+            int32 y = i / width;
+            for(int32 side = TopWall; side <= LeftWall; side++)
+            {
+                if(!canStep(Tiles, x, y, side)) continue;
+                
+                int32 n = i + stepY[side] * width + stepX[side];
+                if(Costs[n] == 0) continue;
+                
+                uint32_t nd = min(d + Costs[n], (uint32_t)MaxDistance);
+                if(nd >= distance[n]) continue;
+                distance[n] = (uint16_t)nd;
+                buckets[nd & 255].push_back(n);
+                pending++;
+            }
+        }
+        bucket.clear();
+    }
+}
+
+void DistanceField::Flow(const TileGrid& Tiles, vector<uint8_t>& Directions) const
+{
+    Directions.assign(distance.size(), FlowNone);
+    for(int32 y = 0; y < height; y++)
+    {
+        for(int32 x = 0; x < width; x++)
+        {
+            int32 i = y * width + x;
+            uint16_t best = distance[i];
+            if(best == Unreachable || best == 0) continue;
+            
+            for(int32 side = TopWall; side <= LeftWall; side++)
+            {
+                if(!canStep(Tiles, x, y, side)) continue;
+                
+                uint16_t d = distance[i + stepY[side] * width + stepX[side]];
+                if(d < best)
+                {
+                    best = d;
+                    Directions[i] = (uint8_t)side;
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
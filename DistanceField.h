@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "IPoint.h"
+#include "TileGrid.h"
+#include "Helper.h"
+
+/** Step direction of a flow field tile, TopWall..LeftWall, or FlowNone at a source or where nothing is reachable. **/
+static const uint8_t FlowNone = 4;
+
+/**
+ * Steps from the nearest of a set of source tiles to every walkable tile of a
+ * TileGrid, one uint16_t per tile.
+ *
+ * Walkable tiles are floor, and a step between two tiles is allowed where the
+ * edge between them is not blocked, so closed doors stop the search. Sources
+ * and results are in tile coordinates of the grid, not of the map. Distances
+ * stop at MaxDistance, tiles that cannot be reached hold Unreachable.
+ */
+class DistanceField
+{
+public:
+    static const uint16_t Unreachable = 0xFFFF;
+    static const uint16_t MaxDistance = 0xFFFE;
+    
+    DistanceField() : width(0), height(0) {}
+    
+    /**
+     * Breadth first search from Sources. With more than one thread, each ring of the
+     * search is shared between Threads threads, 0 for one per core, giving the same field.
+     */
+    void Compute(const TileGrid& Tiles, const std::vector<IPoint>& Sources, int32 Threads = 1);
+    
+    /**
+     * Cheapest path from Sources, entering tile i costing Costs[i] and Costs[i] == 0
+     * making the tile impassable. Costs has one byte per tile, row major.
+     */
+    void Compute(const TileGrid& Tiles, const std::vector<IPoint>& Sources, const uint8_t* Costs);
+    
+    /** For every tile, the side to step through to get nearer a source, FlowNone where there is none. **/
+    void Flow(const TileGrid& Tiles, std::vector<uint8_t>& Directions) const;
+    
+    int32 Width() const { return width; }
+    int32 Height() const { return height; }
+    uint16_t At(int32 x, int32 y) const { return distance[(size_t)y * width + x]; }
+    const uint16_t* Data() const { return distance.data(); }
+    
+private:
+    int32 width;
+    int32 height;
+    std::vector<uint16_t> distance;
+    
+    // Reset the field to Tiles' size and place the sources, returning the first ring of the search.
+    void Start(const TileGrid& Tiles, const std::vector<IPoint>& Sources, std::vector<int32>& Frontier);
+};
\ No newline at end of file
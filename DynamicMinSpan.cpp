@@ -0,0 +1,235 @@
+#include "DynamicMinSpan.h"
+#include "Kruskal.h"
+#include "UnionFind.h"
+
+#include <algorithm>
+
+using namespace std;
+
+DynamicMinSpan::DynamicMinSpan(vector<FPoint*>& vertices, vector<Edge*>& edges)
+{
+    int32 nVerts = vertices.size();
+    
+    // A tree at level i has at most V / 2^i vertices, so levels past log2(V) stay empty.
+    Levels = 1;
+    while((1 << (Levels - 1)) < nVerts)
+    {
+        Levels++;
+    }
+    Levels++;
+    
+    Forests.resize(Levels);
+    NonTree.resize(Levels);
+    for(int32 i = 0; i < Levels; i++)
+    {
+        Forests[i] = new EulerTourForest(nVerts, 0x9E3779B9u + i);
+        NonTree[i].resize(nVerts);
+    }
+    Incident.resize(nVerts);
+    
+    int32 len = edges.size();
+    for(int32 i = 0; i < len; i++)
+    {
+        int32 s = edges[i]->s;
+        int32 t = edges[i]->t;
+        if(s == t || Lookup.count(PairKey(s, t))) continue;
+        
+        SpanEdge e;
+        e.s = s;
+        e.t = t;
+        e.Level = 0;
+        e.InTree = false;
+        e.Removed = false;
+        
+        int32 distance = Kruskal::metric_dist(*vertices[s], *vertices[t]);
+        e.Rank = ((uint64_t)(uint32_t)distance << 32) | (uint32_t)Edges.size();
+        
+        Lookup[PairKey(s, t)] = Edges.size();
+        Incident[s].push_back(Edges.size());
+        Incident[t].push_back(Edges.size());
+        Edges.push_back(e);
+    }
+    
+    // Initial forest by Kruskal, every edge starts on level 0.
+    vector<uint64_t> order;
+    order.reserve(Edges.size());
+    for(const SpanEdge& e : Edges)
+    {
+        order.push_back(e.Rank);
+    }
+    sort(order.begin(), order.end());
+    
+    UnionFind<int32> forest(nVerts);
+    for(uint64_t r : order)
+    {
+        int32 e = (int32)(r & 0xFFFFFFFFu);
+        if(forest.link(Edges[e].s, Edges[e].t))
+        {
+            AddTree(e, 0);
+        }
+        else
+        {
+            AddNonTree(e, 0);
+        }
+    }
+}
+
+DynamicMinSpan::~DynamicMinSpan()
+{
+    deleteContainerContents(Forests);
+}
+
+uint64_t DynamicMinSpan::PairKey(int32 s, int32 t)
+{
+    if(s > t) swap(s, t);
+    return ((uint64_t)(uint32_t)s << 32) | (uint32_t)t;
+}
+
+// Publish the cheapest non tree edge of v on this level to the level's forest.
+void DynamicMinSpan::RefreshVertex(int32 level, int32 v)
+{
+    const set<uint64_t>& ranks = NonTree[level][v];
+    Forests[level]->SetVertexValue(v, ranks.empty() ? EulerTourForest::NoValue : *ranks.begin());
+}
+
+void DynamicMinSpan::AddTree(int32 e, int32 level)
+{
+    SpanEdge& edge = Edges[e];
+    edge.InTree = true;
+    edge.Level = level;
+    
+    // The edge is flagged only in the forest of its own level.
+    for(int32 i = 0; i <= level; i++)
+    {
+        Forests[i]->Link(edge.s, edge.t, e, i == level);
+    }
+    TreeRanks.insert(edge.Rank);
+}
+
+void DynamicMinSpan::AddNonTree(int32 e, int32 level)
+{
+    SpanEdge& edge = Edges[e];
+    edge.InTree = false;
+    edge.Level = level;
+    
+    NonTree[level][edge.s].insert(edge.Rank);
+    NonTree[level][edge.t].insert(edge.Rank);
+    RefreshVertex(level, edge.s);
+    RefreshVertex(level, edge.t);
+}
+
+void DynamicMinSpan::RemoveNonTree(int32 e)
+{
+    SpanEdge& edge = Edges[e];
+    
+    NonTree[edge.Level][edge.s].erase(edge.Rank);
+    NonTree[edge.Level][edge.t].erase(edge.Rank);
+    RefreshVertex(edge.Level, edge.s);
+    RefreshVertex(edge.Level, edge.t);
+}
+
+bool DynamicMinSpan::RemoveEdge(int32 s, int32 t, list<int32>* Replacements)
+{
+    unordered_map<uint64_t, int32>::iterator itr = Lookup.find(PairKey(s, t));
+    if(itr == Lookup.end() || Edges[itr->second].Removed) return false;
+    
+    RemoveEdge(itr->second, Replacements);
+    return true;
+}
+
+void DynamicMinSpan::RemoveVertex(int32 v, list<int32>* Replacements)
+{
+    for(int32 e : Incident[v])
+    {
+        if(!Edges[e].Removed)
+        {
+            RemoveEdge(e, Replacements);
+        }
+    }
+}
+
+void DynamicMinSpan::RemoveEdge(int32 e, list<int32>* Replacements)
+{
+    SpanEdge& edge = Edges[e];
+    edge.Removed = true;
+    
+    if(!edge.InTree)
+    {
+        RemoveNonTree(e);
+        return;
+    }
+    
+    for(int32 i = 0; i <= edge.Level; i++)
+    {
+        Forests[i]->Cut(e);
+    }
+    edge.InTree = false;
+    TreeRanks.erase(edge.Rank);
+    
+    Reconnect(edge.s, edge.t, edge.Level, Replacements);
+}
+
+// Look for the cheapest edge joining the trees of v and w, starting from level and working down.
+void DynamicMinSpan::Reconnect(int32 v, int32 w, int32 level, list<int32>* Replacements)
+{
+    for(int32 i = level; i >= 0; i--)
+    {
+        EulerTourForest* forest = Forests[i];
+        
+        // Search the smaller half, it is small enough to move up a level.
+        int32 side = (forest->TreeSize(v) <= forest->TreeSize(w)) ? v : w;
+        
+        int32 f;
+        while((f = forest->FindFlaggedEdge(side)) != -1)
+        {
+            forest->SetEdgeFlag(f, false);
+            Edges[f].Level = i + 1;
+            Forests[i + 1]->Link(Edges[f].s, Edges[f].t, f, true);
+        }
+        
+        uint64_t rank;
+        while((rank = forest->TreeMin(side)) != EulerTourForest::NoValue)
+        {
+            f = (int32)(rank & 0xFFFFFFFFu);
+            SpanEdge& edge = Edges[f];
+            
+            RemoveNonTree(f);
+            if(forest->Connected(edge.s, side) && forest->Connected(edge.t, side))
+            {
+                // Both ends on the same side, it can never reconnect this level again.
+                AddNonTree(f, i + 1);
+            }
+            else
+            {
+                AddTree(f, i);
+                if(Replacements)
+                {
+                    Replacements->push_back(edge.s);
+                    Replacements->push_back(edge.t);
+                }
+                return;
+            }
+        }
+    }
+}
+
+bool DynamicMinSpan::Connected(int32 u, int32 v)
+{
+    return Forests[0]->Connected(u, v);
+}
+
+bool DynamicMinSpan::IsTreeEdge(int32 s, int32 t) const
+{
+    unordered_map<uint64_t, int32>::const_iterator itr = Lookup.find(PairKey(s, t));
+    return (itr != Lookup.end()) && Edges[itr->second].InTree;
+}
+
+void DynamicMinSpan::GetMinSpan(list<int32>& minSpan) const
+{
+    for(uint64_t r : TreeRanks)
+    {
+        const SpanEdge& edge = Edges[(int32)(r & 0xFFFFFFFFu)];
+        minSpan.push_back(edge.s);
+        minSpan.push_back(edge.t);
+    }
+}
\ No newline at end of file
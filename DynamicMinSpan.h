@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <stdint.h>
+#include "Delaunay.h"
+#include "FPoint.h"
+#include "EulerTourForest.h"
+#include "Helper.h"
+
+/**
+ * Minimum spanning forest of the room graph that is kept up to date as edges and
+ * rooms are removed, so editing a map does not mean rerunning CalcMinSpan.
+ *
+ * This is the decremental minimum spanning forest of Holm, de Lichtenberg and Thorup.
+ * Every edge has a level, the forest of tree edges with level >= i is kept as an
+ * Euler tour forest per level. When a tree edge is removed the smaller half is
+ * searched level by level for the cheapest non tree edge reconnecting it, and
+ * every edge that was looked at and rejected moves up a level. An edge can only
+ * rise O(log V) times, so a deletion costs O(log^2 V) amortised.
+ *
+ * Edges are ranked by (distance, edge index) like Kruskal, so GetMinSpan always
+ * returns exactly the tree Kruskal would build from the remaining edges.
+ */
+class DynamicMinSpan
+{
+public:
+    /**
+     * Vertices holds the room centres, edges every edge of the graph (tree and non tree).
+     * Self loops and repeated edges are ignored. Neither vector is modified.
+     */
+    DynamicMinSpan(std::vector<FPoint*>& vertices, std::vector<Edge*>& edges);
+    ~DynamicMinSpan();
+    
+    /**
+     * Remove the edge between s and t. If it was a tree edge the cheapest replacement
+     * is linked in and appended to Replacements as a vertex pair.
+     * Returns false if there is no such edge.
+     */
+    bool RemoveEdge(int32 s, int32 t, std::list<int32>* Replacements = nullptr);
+    
+    /** Remove every edge of vertex v, reconnecting the rest of the graph where possible. **/
+    void RemoveVertex(int32 v, std::list<int32>* Replacements = nullptr);
+    
+    bool Connected(int32 u, int32 v);
+    bool IsTreeEdge(int32 s, int32 t) const;
+    int32 TreeEdgeCount() const { return TreeRanks.size(); }
+    
+    /** Append the current tree as vertex pairs, in the order Kruskal would report it. **/
+    void GetMinSpan(std::list<int32>& minSpan) const;
+    
+private:
+    typedef struct
+    {
+        int32 s, t;
+        uint64_t Rank;
+        int32 Level;
+        bool InTree;
+        bool Removed;
+    } SpanEdge;
+    
+    int32 Levels;
+    std::vector<SpanEdge> Edges;
+    std::vector<EulerTourForest*> Forests;                  // Forests[i] holds tree edges with level >= i.
+    std::vector<std::vector<std::set<uint64_t> > > NonTree; // [level][vertex] ranks of non tree edges.
+    std::vector<std::vector<int32> > Incident;
+    std::unordered_map<uint64_t, int32> Lookup;
+    std::set<uint64_t> TreeRanks;
+    
+    static uint64_t PairKey(int32 s, int32 t);
+    
+    void RefreshVertex(int32 level, int32 v);
+    void AddTree(int32 e, int32 level);
+    void AddNonTree(int32 e, int32 level);
+    void RemoveNonTree(int32 e);
+    void RemoveEdge(int32 e, std::list<int32>* Replacements);
+    void Reconnect(int32 v, int32 w, int32 level, std::list<int32>* Replacements);
+};
\ No newline at end of file
@@ -0,0 +1,312 @@
+#include "EulerTourForest.h"
+#include <algorithm>
+
+using namespace std;
+
+const uint64_t EulerTourForest::NoValue;
+
+EulerTourForest::EulerTourForest(int32 N, uint32_t Seed)
+{
+    RandState = (Seed != 0) ? Seed : 1;
+    
+    Vertices.resize(N);
+    for(int32 i = 0; i < N; i++)
+    {
+        Node& n = Vertices[i];
+        n.Left = n.Right = n.Parent = nullptr;
+        n.Priority = NextPriority();
+        n.Id = i;
+        n.IsVertex = true;
+        n.Flag = false;
+        n.Value = NoValue;
+        Update(&n);
+    }
+}
+
+EulerTourForest::~EulerTourForest()
+{
+    for(auto& a : Arcs)
+    {
+        delete a.second.Forward;
+        delete a.second.Backward;
+    }
+    deleteContainerContents(FreeArcs);
+}
+
+uint32_t EulerTourForest::NextPriority()
+{
+    // xorshift32, treap priorities only need to be well spread.
+    RandState ^= RandState << 13;
+    RandState ^= RandState >> 17;
+    RandState ^= RandState << 5;
+    return RandState;
+}
+
+EulerTourForest::Node* EulerTourForest::NewArc(int32 EdgeId)
+{
+    Node* n;
+    if(!FreeArcs.empty())
+    {
+        n = FreeArcs.back();
+        FreeArcs.pop_back();
+    }
+    else
+    {
+        n = new Node();
+    }
+    n->Left = n->Right = n->Parent = nullptr;
+    n->Priority = NextPriority();
+    n->Id = EdgeId;
+    n->IsVertex = false;
+    n->Flag = false;
+    n->Value = NoValue;
+    Update(n);
+    return n;
+}
+
+void EulerTourForest::FreeArc(Node* n)
+{
+    FreeArcs.push_back(n);
+}
+
+void EulerTourForest::Update(Node* n)
+{
+    n->Count = n->IsVertex ? 1 : 0;
+    n->SubFlag = n->Flag;
+    n->SubMin = n->IsVertex ? n->Value : NoValue;
+    
+    if(n->Left)
+    {
+        n->Count += n->Left->Count;
+        n->SubFlag |= n->Left->SubFlag;
+        n->SubMin = min(n->SubMin, n->Left->SubMin);
+    }
+    if(n->Right)
+    {
+        n->Count += n->Right->Count;
+        n->SubFlag |= n->Right->SubFlag;
+        n->SubMin = min(n->SubMin, n->Right->SubMin);
+    }
+}
+
+void EulerTourForest::UpdatePath(Node* n)
+{
+    while(n)
+    {
+        Update(n);
+        n = n->Parent;
+    }
+}
+
+EulerTourForest::Node* EulerTourForest::Root(Node* n)
+{
+    while(n->Parent)
+    {
+        n = n->Parent;
+    }
+    return n;
+}
+
+EulerTourForest::Node* EulerTourForest::Merge(Node* a, Node* b)
+{
+    if(!a) return b;
+    if(!b) return a;
+    
+    if(a->Priority > b->Priority)
+    {
+        Node* m = Merge(a->Right, b);
+        a->Right = m;
+        m->Parent = a;
+        Update(a);
+        return a;
+    }
+    else
+    {
+        Node* m = Merge(a, b->Left);
+        b->Left = m;
+        m->Parent = b;
+        Update(b);
+        return b;
+    }
+}
+
+// Split the tour containing x into everything before x and x onwards.
+void EulerTourForest::SplitBefore(Node* x, Node*& l, Node*& r)
+{
+    l = x->Left;
+    if(l) l->Parent = nullptr;
+    x->Left = nullptr;
+    r = x;
+    
+    Node* cur = x;
+    Node* p = x->Parent;
+    x->Parent = nullptr;
+    Update(x);
+    
+    while(p)
+    {
+        Node* pp = p->Parent;
+        bool wasRight = (p->Right == cur);
+        p->Parent = nullptr;
+        
+        if(wasRight)
+        {
+            // p and its left subtree come before x.
+            p->Right = l;
+            if(l) l->Parent = p;
+            Update(p);
+            l = p;
+        }
+        else
+        {
+            // p and its right subtree come after x.
+            p->Left = r;
+            r->Parent = p;
+            Update(p);
+            r = p;
+        }
+        
+        cur = p;
+        p = pp;
+    }
+}
+
+// Split the tour containing x into everything up to x and everything after it.
+void EulerTourForest::SplitAfter(Node* x, Node*& l, Node*& r)
+{
+    r = x->Right;
+    if(r) r->Parent = nullptr;
+    x->Right = nullptr;
+    l = x;
+    
+    Node* cur = x;
+    Node* p = x->Parent;
+    x->Parent = nullptr;
+    Update(x);
+    
+    while(p)
+    {
+        Node* pp = p->Parent;
+        bool wasLeft = (p->Left == cur);
+        p->Parent = nullptr;
+        
+        if(wasLeft)
+        {
+            // p and its right subtree come after x.
+            p->Left = r;
+            if(r) r->Parent = p;
+            Update(p);
+            r = p;
+        }
+        else
+        {
+            // p and its left subtree come before x.
+            p->Right = l;
+            l->Parent = p;
+            Update(p);
+            l = p;
+        }
+        
+        cur = p;
+        p = pp;
+    }
+}
+
+// Rotate the tour so it starts at vertex node v, returns the new root.
+EulerTourForest::Node* EulerTourForest::Reroot(Node* v)
+{
+    Node* l;
+    Node* r;
+    SplitBefore(v, l, r);
+    return Merge(r, l);
+}
+
+bool EulerTourForest::Connected(int32 u, int32 v)
+{
+    return Root(&Vertices[u]) == Root(&Vertices[v]);
+}
+
+int32 EulerTourForest::TreeSize(int32 v)
+{
+    return Root(&Vertices[v])->Count;
+}
+
+void EulerTourForest::Link(int32 u, int32 v, int32 EdgeId, bool Flag)
+{
+    ArcPair arcs;
+    arcs.U = u;
+    arcs.Forward = NewArc(EdgeId);
+    arcs.Backward = NewArc(EdgeId);
+    arcs.Forward->Flag = Flag;
+    Update(arcs.Forward);
+    Arcs[EdgeId] = arcs;
+    
+    // Tour of u, arc u->v, tour of v, arc v->u.
+    Node* tu = Reroot(&Vertices[u]);
+    Node* tv = Reroot(&Vertices[v]);
+    Merge(Merge(tu, arcs.Forward), Merge(tv, arcs.Backward));
+}
+
+void EulerTourForest::Cut(int32 EdgeId)
+{
+    unordered_map<int32, ArcPair>::iterator itr = Arcs.find(EdgeId);
+    if(itr == Arcs.end()) return;
+    
+    ArcPair arcs = itr->second;
+    Arcs.erase(itr);
+    
+    // Rooted at u the tour reads A, u->v, B, v->u, C where B is the tour of v's side.
+    Reroot(&Vertices[arcs.U]);
+    
+    Node* a;
+    Node* rest;
+    Node* b;
+    Node* c;
+    Node* arc;
+    SplitBefore(arcs.Forward, a, rest);
+    SplitAfter(arcs.Forward, arc, rest);
+    SplitBefore(arcs.Backward, b, rest);
+    SplitAfter(arcs.Backward, arc, c);
+    Merge(a, c);
+    
+    FreeArc(arcs.Forward);
+    FreeArc(arcs.Backward);
+}
+
+void EulerTourForest::SetVertexValue(int32 v, uint64_t Value)
+{
+    Node* n = &Vertices[v];
+    if(n->Value == Value) return;
+    
+    n->Value = Value;
+    UpdatePath(n);
+}
+
+void EulerTourForest::SetEdgeFlag(int32 EdgeId, bool Flag)
+{
+    unordered_map<int32, ArcPair>::iterator itr = Arcs.find(EdgeId);
+    if(itr == Arcs.end()) return;
+    
+    Node* n = itr->second.Forward;
+    if(n->Flag == Flag) return;
+    
+    n->Flag = Flag;
+    UpdatePath(n);
+}
+
+uint64_t EulerTourForest::TreeMin(int32 v)
+{
+    return Root(&Vertices[v])->SubMin;
+}
+
+int32 EulerTourForest::FindFlaggedEdge(int32 v)
+{
+    Node* n = Root(&Vertices[v]);
+    if(!n->SubFlag) return -1;
+    
+    while(!n->Flag)
+    {
+        n = (n->Left && n->Left->SubFlag) ? n->Left : n->Right;
+    }
+    return n->Id;
+}
\ No newline at end of file
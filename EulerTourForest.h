@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "Helper.h"
+
+/**
+ * A forest of Euler tour trees over a fixed set of vertices.
+ *
+ * Each tree is stored as its Euler tour in a treap, with one node per vertex and
+ * two arc nodes per tree edge. Link, cut and connectivity queries run in
+ * expected O(log N).
+ *
+ * Every vertex can carry a 64 bit value and every edge a flag. Each tree keeps
+ * the minimum vertex value and whether any edge in it is flagged, so callers
+ * can find the smallest value or a flagged edge of a tree without walking it.
+ */
+class EulerTourForest
+{
+public:
+    static const uint64_t NoValue = UINT64_MAX;
+    
+    EulerTourForest(int32 N, uint32_t Seed = 1);
+    ~EulerTourForest();
+    
+    // Are vertices u and v in the same tree?
+    bool Connected(int32 u, int32 v);
+    
+    // Number of vertices in the tree containing v.
+    int32 TreeSize(int32 v);
+    
+    // Join the trees of u and v with the edge EdgeId. u and v must be in different trees.
+    void Link(int32 u, int32 v, int32 EdgeId, bool Flag = false);
+    
+    // Remove the edge EdgeId, splitting its tree in two.
+    void Cut(int32 EdgeId);
+    
+    bool HasEdge(int32 EdgeId) const { return Arcs.count(EdgeId) != 0; }
+    
+    void SetVertexValue(int32 v, uint64_t Value);
+    void SetEdgeFlag(int32 EdgeId, bool Flag);
+    
+    // Smallest vertex value in the tree containing v, NoValue if none is set.
+    uint64_t TreeMin(int32 v);
+    
+    // Any flagged edge in the tree containing v, -1 if there are none.
+    int32 FindFlaggedEdge(int32 v);
+    
+private:
+    struct Node
+    {
+        Node* Left;
+        Node* Right;
+        Node* Parent;
+        uint32_t Priority;
+        int32 Id;           // Vertex index or edge id.
+        int32 Count;        // Vertex nodes in this subtree.
+        bool IsVertex;
+        bool Flag;
+        bool SubFlag;       // Any flagged node in this subtree.
+        uint64_t Value;
+        uint64_t SubMin;    // Smallest vertex value in this subtree.
+    };
+    
+    struct ArcPair
+    {
+        int32 U;
+        Node* Forward;      // u -> v, carries the edge flag.
+        Node* Backward;     // v -> u
+    };
+    
+    std::vector<Node> Vertices;
+    std::vector<Node*> FreeArcs;
+    std::unordered_map<int32, ArcPair> Arcs;
+    uint32_t RandState;
+    
+    uint32_t NextPriority();
+    Node* NewArc(int32 EdgeId);
+    void FreeArc(Node* n);
+    
+    static void Update(Node* n);
+    static void UpdatePath(Node* n);
+    static Node* Root(Node* n);
+    static Node* Merge(Node* a, Node* b);
+    static void SplitBefore(Node* x, Node*& l, Node*& r);
+    static void SplitAfter(Node* x, Node*& l, Node*& r);
+    static Node* Reroot(Node* v);
+};
\ No newline at end of file
@@ -1,25 +1,38 @@
-#pragma once
-#include <string>   // std::string
-#include <sstream>  // std::ostringstream
-
-typedef int int32;
-
-namespace std
-{
-    template <typename T> std::string to_string(const T& val)
-    {
-        std::ostringstream os;
-        os << val;
-        return os.str();
-    }
-}
-
-template<typename Container>
-void deleteContainerContents(Container &c)
-{
-    while(!c.empty())
-    {
-        delete c.back();
-        c.pop_back();
-    }
+#pragma once
+#include <string>   // std::string
+#include <sstream>  // std::ostringstream
+#include <stdint.h> // uint64_t
+
+typedef int int32;
+
+static const uint64_t HashSeed = 14695981039346656037ULL;
+
+/** Fold the 8 bytes of Value into Hash, FNV-1a, starting from HashSeed. **/
+inline uint64_t HashCombine(uint64_t Hash, uint64_t Value)
+{
+    for(int32 i = 0; i < 8; i++)
+    {
+        Hash = (Hash ^ ((Value >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+    }
+    return Hash;
+}
+
+namespace std
+{
+    template <typename T> std::string to_string(const T& val)
+    {
+        std::ostringstream os;
+        os << val;
+        return os.str();
+    }
+}
+
+template<typename Container>
+void deleteContainerContents(Container &c)
+{
+    while(!c.empty())
+    {
+        delete c.back();
+        c.pop_back();
+    }
 }
\ No newline at end of file
@@ -1,440 +1,901 @@
-#include "MapBuilderLib.h"
-#include <cstdlib>
-#include <iostream>
-#include <random>
-#include <algorithm>
-#include <cmath>
-#include "IRect.h"
-#include "IPoint.h"
-#include "Delaunay.h"
-#include "Kruskal.h"
-
-using namespace std;
-
-void UMapBuilderLib::InitMap(MapInfoType& MapInfo, int32 Width, int32 Height)
-{
-    /** Check width and height are valid values. **/
-    if(Width == 0 || Height == 0)
-    {
-        return;
-    }
-    
-    /** Clear any previously set data and free memory. **/
-    if(MapInfo.IsInitialised)
-    {
-        UMapBuilderLib::ClearMap(MapInfo);
-    }
-    
-    MapInfo.Width = Width;
-    MapInfo.Height = Height;
-    
-    /** Set initialisation flag to note map info is valid. **/
-    MapInfo.IsInitialised = true;
-}
-
-void UMapBuilderLib::ClearMap(MapInfoType& MapInfo)
-{
-    /** Delete all dynamically allocated rooms. **/
-    int32 len = MapInfo.Rooms.size();
-    
-    for(int32 i = 0; i < len; i++)
-    {
-        /** Individual rooms manually deleted. **/
-        delete MapInfo.Rooms[i];
-    }
-    /** Reset the vector back to zero (hopefully). **/
-    MapInfo.Rooms.clear();
-    MapInfo.Rooms.shrink_to_fit();
-    
-    /** Delete all dynamically allocated corridors. **/
-    len = MapInfo.Corridors.size();
-    
-    for(int32 i = 0; i < len; i++)
-    {
-        /** Individual corridors manually deleted. **/
-        delete MapInfo.Corridors[i];
-    }
-    /** Reset the vector back to zero (hopefully). **/
-    MapInfo.Corridors.clear();
-    MapInfo.Corridors.shrink_to_fit();
-    
-    /** Reset initialisation flag to note map info is no longer valid. **/
-    MapInfo.IsInitialised = false;
-}
-
-void UMapBuilderLib::MakeRooms(MapInfoType& MapInfo, int32 Num, int32 minLen, int32 maxLen, int32 XOrigin, int32 YOrigin, int32 WidthMargin, int32 HeightMargin)
-{
-    if(!MapInfo.IsInitialised) return;
-    
-    if(minLen <= 0) minLen = 2;
-    if(maxLen <= minLen) maxLen = minLen + 10;
-    if(maxLen < MapInfo.MaxRoomWidth) maxLen = MapInfo.MaxRoomWidth;
-    if(maxLen < MapInfo.MaxRoomHeight) maxLen = MapInfo.MaxRoomHeight;
-    
-    srand(MapInfo.Seed);
-    
-    default_random_engine generatorX(rand());
-    uniform_int_distribution<int32> distributionX(XOrigin - WidthMargin, XOrigin + WidthMargin);
-    auto RandomX = bind ( distributionX, generatorX );
-    
-    default_random_engine generatorY(rand());
-    uniform_int_distribution<int32> distributionY(YOrigin - HeightMargin, YOrigin + HeightMargin);
-    auto RandomY = bind ( distributionY, generatorY );
-    
-    default_random_engine generatorDim(rand());
-    uniform_int_distribution<int32> distributionDim(minLen, maxLen);
-    auto RandomDim = bind ( distributionDim, generatorDim );
-    
-    for(int32 i = 0; i < Num; i++)
-    {
-        int32 x = RandomX();
-        int32 y = RandomY();
-        int32 w = RandomDim();
-        int32 h = RandomDim();
-        MapInfo.Rooms.push_back(new Room(x, y, w, h));
-    }
-}
-
-bool UMapBuilderLib::SeparateRooms(MapInfoType & MapInfo)
-{
-    IPoint force;
-    int interactions = 0;
-    
-    vector<Room*> rooms = MapInfo.Rooms;
-    int len = rooms.size();
-    
-    for(int i = 0; i < len; i++)
-    {
-        IRect* currRoom = &rooms[i]->Bounds;
-        
-        for(int j = 0; j < len; j++)
-        {
-            if(j == i) continue;
-            
-            IRect* nextRoom = &rooms[j]->Bounds;
-            
-            if(currRoom->IsIntersecting(*nextRoom))
-            {
-                IPoint* pen = currRoom->Penetration(*nextRoom);
-                
-                if(abs(pen->X) > abs(force.X))
-                {
-                    force.X = pen->X;
-                }
-                if(abs(pen->Y) > abs(force.Y))
-                {
-                    force.Y = pen->Y;
-                }
-                
-                delete pen;
-            }
-        }
-        
-        if(force.X != 0 && force.Y != 0)
-        {
-            interactions++;
-            if(abs(force.X) < abs(force.Y))
-            {
-                currRoom->Position.X += force.X;
-            }
-            else
-            {
-                currRoom->Position.Y += force.Y;
-            }
-            
-            force.Zero();
-        }
-    }
-    
-    return (interactions == 0);
-}
-
-static bool IsMarkedToDelete(Room* r)
-{
-    return r->Enabled == false;
-}
-
-void UMapBuilderLib::RemoveRoomsBelowRatio(MapInfoType& MapInfo, float ratio)
-{
-    int len = MapInfo.Rooms.size();
-    int i = 0;
-    
-    while(i < len)
-    {
-        IRect* currRoom = &MapInfo.Rooms[i]->Bounds;
-        
-        float currRatio;
-        if(currRoom->Width < currRoom->Height)
-        {
-            currRatio = float(currRoom->Width) / float(currRoom->Height);
-        }
-        else
-        {
-            currRatio = float(currRoom->Height) / float(currRoom->Width);
-        }
-        
-        if(currRatio <= ratio)
-        {
-            Room* tmp = MapInfo.Rooms[i];
-            tmp->Enabled = false;
-            
-            // Move current room to end of vector.
-            swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
-            
-            // Delete room and erase element from vector
-            delete tmp;
-            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
-            
-            len--;
-        }
-        else
-        {
-            i++;
-        }
-    }
-}
-
-void UMapBuilderLib::FilterRooms(MapInfoType& MapInfo, RoomFilter& rf)
-{
-    for(Room* r : MapInfo.Rooms)
-    {
-        rf.Filter(*r);
-    }
-}
-
-void UMapBuilderLib::RemoveFiltered(MapInfoType& MapInfo)
-{
-    int len = MapInfo.Rooms.size();
-    int i = 0;
-    
-    while(i < len)
-    {
-        Room* currRoom = MapInfo.Rooms[i];
-        
-        if(currRoom->filter == false)
-        {
-            currRoom->Enabled = false;
-            
-            // Move current room to end of vector.
-            swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
-            
-            // Delete room and erase element from vector
-            delete currRoom;
-            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
-            
-            len--;
-        }
-        else
-        {
-            i++;
-        }
-    }
-}
-
-void UMapBuilderLib::GetRoomCenters(MapInfoType& MapInfo, std::vector<FPoint*>& point)
-{
-    int len = MapInfo.Rooms.size();
-    for(int i = 0; i < len; i++)
-    {
-        Room* r = MapInfo.Rooms[i];
-        
-        point[i]->X = (float)r->Bounds.CenterX();
-        point[i]->Y = (float)r->Bounds.CenterY();
-    }
-}
-
-void UMapBuilderLib::ReduceRooms(MapInfoType& MapInfo)
-{
-    int len = MapInfo.Rooms.size();
-    int i = 0;
-    
-    while(len > MapInfo.MaxRooms)
-    {
-        i = rand() % (len-1);
-        Room* currRoom = MapInfo.Rooms[i];
-        
-        // Move current room to end of vector.
-        currRoom->Enabled = false;
-        swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
-        
-        // Delete room and erase element from vector
-        delete currRoom;
-        MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
-        
-        len--;
-    }
-}
-
-void UMapBuilderLib::SeparateCorridorFeatures(MapInfoType& MapInfo)
-{
-    int len = MapInfo.Rooms.size();
-    int i = 0;
-    
-    while(i < len)
-    {
-        Room* currRoom = MapInfo.Rooms[i];
-        
-        if((currRoom->Bounds.Width < MapInfo.MinRoomWidth) || (currRoom->Bounds.Height < MapInfo.MaxRoomHeight))
-        {
-            // Move current room to end of vector.
-            currRoom->Enabled = false;
-            swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
-            
-            // Convert room to corridor feature.
-            MapInfo.CorridorFeatures.push_back(new CorridorFeature(currRoom));
-            
-            // Delete room and erase element from vector
-            delete currRoom;
-            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
-            
-            len--;
-        }
-        
-        i++;
-    }
-}
-
-Triangulation* UMapBuilderLib::PerformDelaunayTriangulation(MapInfoType& MapInfo)
-{
-    // Create datastructure for calculating connections.
-    Triangulation* tri = new Triangulation(MapInfo.Rooms.size());
-    
-    // Get a vector of all the rooms centre position.
-    UMapBuilderLib::GetRoomCenters(MapInfo, tri->point);
-    
-    // Perform Delaunay triangulation to connect all the rooms.
-    QuadraticAlgorithm qa;
-    qa.triangulate(*tri);
-    
-    return tri;
-}
-list<int32>* UMapBuilderLib::CalcMinSpan(MapInfoType& MapInfo, Triangulation& tri)
-{
-    
-    // Generate a list of the minimum edges required to connect all the rooms
-    list<int32>* minSpan = Kruskal::runKruskal(tri.point, tri.edge);
-    MapInfo.MinConnectedCorridors = minSpan->size();
-    
-    return minSpan;
-}
-
-void UMapBuilderLib::AddRandomEdges(MapInfoType& MapInfo, Triangulation& tri, list<int32>& minSpan)
-{
-    int totalCorridors = (minSpan.size() / 2) + MapInfo.MaxRandomCorridors;
-    // Add some edges at random (this will allow for loops etc.)
-    int edgeLen = tri.edge.size();
-    while((minSpan.size() / 2) < totalCorridors)
-    {
-        int32 index = (int32)(rand() % edgeLen);
-        minSpan.push_back(tri.edge[index]->s);
-        minSpan.push_back(tri.edge[index]->t);
-        
-        swap(tri.edge[index], tri.edge[edgeLen-1]);
-        edgeLen--;
-    }
-}
-
-int32 UMapBuilderLib::DetermineX(Room& r, double ang)
-{
-    // if ang leads to the right of room
-    if(ang >= r.ru || ang <= r.rd)
-    {
-        return r.Bounds.Right();
-    }
-    
-    // if ang leads to the left of room
-    else if(ang <= r.lu && ang >= r.ld)
-    {
-        return r.Bounds.Left();
-    }
-    
-    // if ang leads to the top of room
-    else if(ang > r.lu && ang < r.ru)
-    {
-        return (int32)round(r.Bounds.CenterX() + (r.Bounds.HalfHeight() * tan(ang + (M_PI/2))));
-        
-    }
-    
-    // if ang leads to the top of room
-    else if(ang < r.ld && ang > r.rd)
-    {
-        return (int32)round(r.Bounds.CenterX() - (r.Bounds.HalfHeight() * tan(ang + (M_PI/2))));
-        
-    }
-    return -1;
-}
-
-int32 UMapBuilderLib::DetermineY(Room& r, double ang)
-{
-    // if ang leads to the right of room
-    if(ang >= r.ru || ang <= r.rd)
-    {
-        return (int32)round(r.Bounds.CenterY() + (r.Bounds.HalfWidth() * tan(ang)));
-    }
-    
-    // if ang leads to the left of room
-    else if(ang <= r.lu && ang >= r.ld)
-    {
-        return (int32)round(r.Bounds.CenterY() - (r.Bounds.HalfWidth() * tan(ang)));
-    }
-    
-    // if ang leads to the bottom of room
-    else if(ang > r.lu && ang < r.ru)
-    {
-        return r.Bounds.Top();
-        
-    }
-    
-    // if ang leads to the bottom of room
-    else if(ang < r.ld && ang > r.rd)
-    {
-        return r.Bounds.Bottom();
-    }
-    
-    return -1;
-}
-
-void UMapBuilderLib::CreateCorridorsBetween(MapInfoType& MapInfo, int32 Room1Index, int32 Room2Index)
-{
-    Room* room1 = MapInfo.Rooms[Room1Index];
-    Room* room2 = MapInfo.Rooms[Room2Index];
-    
-    // Get center point for each room
-    int32 x1 = room1->Bounds.CenterX();
-    int32 y1 = room1->Bounds.CenterY();
-    int32 x2 = room2->Bounds.CenterX();
-    int32 y2 = room2->Bounds.CenterY();
-    
-    // Calculate angle from room to room;
-    double angFrom1To2 = atan2(y1-y2, x1-x2);
-    double angFrom2To1 = atan2(y2-y1, x2-x1);
-    
-    // Calculate starting and ending x,y corrds  for corridor.
-    Corridor* c = new Corridor();
-    c->SX = UMapBuilderLib::DetermineX(*room1, angFrom1To2);
-    c->SY = UMapBuilderLib::DetermineY(*room1, angFrom1To2);
-    c->EX = UMapBuilderLib::DetermineX(*room2, angFrom2To1);
-    c->EY = UMapBuilderLib::DetermineY(*room2, angFrom2To1);
-    
-    MapInfo.Corridors.push_back(c);
-}
-
-void UMapBuilderLib::GenerateCorridors(MapInfoType& MapInfo, list<int32>& edges)
-{
-    // Pre calculate all the rooms angles from thier center to their corners.
-    int len = MapInfo.Rooms.size();
-    for(int i = 0; i < len; i++)
-    {
-        MapInfo.Rooms[i]->CalcCorners();
-    }
-    
-    // Generate a corridor for each edge in the edges list.
-    for(list<int32>::iterator itr = edges.begin(); itr != edges.end(); itr++)
-    {
-        // Each edge element contains an index to a point element in the triangulation point list, which in turn should match up to its source Room index in MapInfo
-        int32 room1Ind = (*(itr));
-        itr++;
-        int32 room2Ind = (*(itr));
-        UMapBuilderLib::CreateCorridorsBetween(MapInfo, room1Ind, room2Ind);
-    }
+#include "MapBuilderLib.h"
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include "IRect.h"
+#include "IPoint.h"
+#include "Delaunay.h"
+#include "Kruskal.h"
+#include "Boruvka.h"
+#include "WeightedSampler.h"
+#include "Parallel.h"
+#include "BVH.h"
+#include "MapValidator.h"
+#include "CounterRand.h"
+#include <unordered_set>
+
+using namespace std;
+
+// Rooms made on one thread below this many, as starting threads would cost more than it saves.
+static const int32 MinParallelRooms = 65536;
+
+// Values of RoomStream each room takes, so room i starts at counter i * RoomDraws.
+static const int32 RoomDraws = 4;
+
+void UMapBuilderLib::InitMap(MapInfoType& MapInfo, int32 Width, int32 Height)
+{
+    /** Check width and height are valid values. **/
+    if(Width == 0 || Height == 0)
+    {
+        return;
+    }
+    
+    /** Clear any previously set data and free memory. **/
+    if(MapInfo.IsInitialised)
+    {
+        UMapBuilderLib::ClearMap(MapInfo);
+    }
+    
+    MapInfo.Width = Width;
+    MapInfo.Height = Height;
+    
+    /** Set initialisation flag to note map info is valid. **/
+    MapInfo.IsInitialised = true;
+}
+
+void UMapBuilderLib::ClearMap(MapInfoType& MapInfo)
+{
+    /** Delete all dynamically allocated rooms. **/
+    int32 len = MapInfo.Rooms.size();
+    
+    for(int32 i = 0; i < len; i++)
+    {
+        /** Individual rooms manually deleted. **/
+        delete MapInfo.Rooms[i];
+    }
+    /** Reset the vector back to zero (hopefully). **/
+    MapInfo.Rooms.clear();
+    MapInfo.Rooms.shrink_to_fit();
+    
+    /** Delete all dynamically allocated corridors. **/
+    len = MapInfo.Corridors.size();
+    
+    for(int32 i = 0; i < len; i++)
+    {
+        /** Individual corridors manually deleted. **/
+        delete MapInfo.Corridors[i];
+    }
+    /** Reset the vector back to zero (hopefully). **/
+    MapInfo.Corridors.clear();
+    MapInfo.Corridors.shrink_to_fit();
+    
+    /** Delete all dynamically allocated corridor features and doors. **/
+    deleteContainerContents(MapInfo.CorridorFeatures);
+    MapInfo.CorridorFeatures.shrink_to_fit();
+    deleteContainerContents(MapInfo.Doors);
+    MapInfo.Doors.shrink_to_fit();
+    
+    /** Reset initialisation flag to note map info is no longer valid. **/
+    MapInfo.IsInitialised = false;
+}
+
+void UMapBuilderLib::MakeRooms(MapInfoType& MapInfo, int32 Num, int32 minLen, int32 maxLen, int32 XOrigin, int32 YOrigin, int32 WidthMargin, int32 HeightMargin)
+{
+    if(!MapInfo.IsInitialised) return;
+    
+    if(minLen <= 0) minLen = 2;
+    if(maxLen <= minLen) maxLen = minLen + 10;
+    if(maxLen < MapInfo.MaxRoomWidth) maxLen = MapInfo.MaxRoomWidth;
+    if(maxLen < MapInfo.MaxRoomHeight) maxLen = MapInfo.MaxRoomHeight;
+    
+    if(Num <= 0) return;
+    
+    // Each room reads its own values of the stream, so any block of rooms can be made on its own.
+    int32 first = MapInfo.Rooms.size();
+    MapInfo.Rooms.resize(first + Num);
+    Parallel::For(0, Num, [&](int32 begin, int32 end, int32)
+    {
+        CounterRand rng(MapInfo.Seed, RoomStream, (uint64_t)begin * RoomDraws);
+        for(int32 i = begin; i < end; i++)
+        {
+            int32 x = rng.Range(XOrigin - WidthMargin, XOrigin + WidthMargin);
+            int32 y = rng.Range(YOrigin - HeightMargin, YOrigin + HeightMargin);
+            int32 w = rng.Range(minLen, maxLen);
+            int32 h = rng.Range(minLen, maxLen);
+            MapInfo.Rooms[first + i] = new Room(x, y, w, h);
+        }
+    }, Num >= MinParallelRooms ? 0 : 1);
+}
+
+bool UMapBuilderLib::SeparateRooms(MapInfoType & MapInfo)
+{
+    IPoint force;
+    int interactions = 0;
+    
+    vector<Room*> rooms = MapInfo.Rooms;
+    int len = rooms.size();
+    
+    for(int i = 0; i < len; i++)
+    {
+        IRect* currRoom = &rooms[i]->Bounds;
+        
+        for(int j = 0; j < len; j++)
+        {
+            if(j == i) continue;
+            
+            IRect* nextRoom = &rooms[j]->Bounds;
+            
+            if(currRoom->IsIntersecting(*nextRoom))
+            {
+                IPoint* pen = currRoom->Penetration(*nextRoom);
+                
+                if(abs(pen->X) > abs(force.X))
+                {
+                    force.X = pen->X;
+                }
+                if(abs(pen->Y) > abs(force.Y))
+                {
+                    force.Y = pen->Y;
+                }
+                
+                delete pen;
+            }
+        }
+        
+        if(force.X != 0 && force.Y != 0)
+        {
+            interactions++;
+            if(abs(force.X) < abs(force.Y))
+            {
+                currRoom->Position.X += force.X;
+            }
+            else
+            {
+                currRoom->Position.Y += force.Y;
+            }
+            
+            force.Zero();
+        }
+    }
+    
+    return (interactions == 0);
+}
+
+static bool IsMarkedToDelete(Room* r)
+{
+    return r->Enabled == false;
+}
+
+void UMapBuilderLib::RemoveRoomsBelowRatio(MapInfoType& MapInfo, float ratio)
+{
+    int len = MapInfo.Rooms.size();
+    int i = 0;
+    
+    while(i < len)
+    {
+        IRect* currRoom = &MapInfo.Rooms[i]->Bounds;
+        
+        float currRatio;
+        if(currRoom->Width < currRoom->Height)
+        {
+            currRatio = float(currRoom->Width) / float(currRoom->Height);
+        }
+        else
+        {
+            currRatio = float(currRoom->Height) / float(currRoom->Width);
+        }
+        
+        if(currRatio <= ratio)
+        {
+            Room* tmp = MapInfo.Rooms[i];
+            tmp->Enabled = false;
+            
+            // Move current room to end of vector.
+            swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
+            
+            // Delete room and erase element from vector
+            delete tmp;
+            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
+            
+            len--;
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void UMapBuilderLib::FilterRooms(MapInfoType& MapInfo, RoomFilter& rf)
+{
+    for(Room* r : MapInfo.Rooms)
+    {
+        rf.Filter(*r);
+    }
+}
+
+void UMapBuilderLib::RemoveFiltered(MapInfoType& MapInfo)
+{
+    int len = MapInfo.Rooms.size();
+    int i = 0;
+    
+    while(i < len)
+    {
+        Room* currRoom = MapInfo.Rooms[i];
+        
+        if(currRoom->filter == false)
+        {
+            currRoom->Enabled = false;
+            
+            // Move current room to end of vector.
+            swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
+            
+            // Delete room and erase element from vector
+            delete currRoom;
+            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
+            
+            len--;
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void UMapBuilderLib::GetRoomCenters(MapInfoType& MapInfo, std::vector<FPoint*>& point)
+{
+    int len = MapInfo.Rooms.size();
+    for(int i = 0; i < len; i++)
+    {
+        Room* r = MapInfo.Rooms[i];
+        
+        point[i]->X = (float)r->Bounds.CenterX();
+        point[i]->Y = (float)r->Bounds.CenterY();
+    }
+}
+
+void UMapBuilderLib::ReduceRooms(MapInfoType& MapInfo)
+{
+    int len = MapInfo.Rooms.size();
+    int i = 0;
+    CounterRand rng(MapInfo.Seed, ReduceStream);
+    
+    while(len > MapInfo.MaxRooms)
+    {
+        i = rng.Below(len - 1);
+        Room* currRoom = MapInfo.Rooms[i];
+        
+        // Move current room to end of vector.
+        currRoom->Enabled = false;
+        swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
+        
+        // Delete room and erase element from vector
+        delete currRoom;
+        MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
+        
+        len--;
+    }
+}
+
+void UMapBuilderLib::SeparateCorridorFeatures(MapInfoType& MapInfo)
+{
+    int len = MapInfo.Rooms.size();
+    int i = 0;
+    
+    while(i < len)
+    {
+        Room* currRoom = MapInfo.Rooms[i];
+        
+        if((currRoom->Bounds.Width < MapInfo.MinRoomWidth) || (currRoom->Bounds.Height < MapInfo.MaxRoomHeight))
+        {
+            // Move current room to end of vector.
+            currRoom->Enabled = false;
+            swap(MapInfo.Rooms[i], MapInfo.Rooms[len-1]);
+            
+            // Convert room to corridor feature.
+            MapInfo.CorridorFeatures.push_back(new CorridorFeature(currRoom));
+            
+            // Delete room and erase element from vector
+            delete currRoom;
+            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + len - 1);
+            
+            len--;
+        }
+        
+        i++;
+    }
+}
+
+Triangulation* UMapBuilderLib::PerformDelaunayTriangulation(MapInfoType& MapInfo)
+{
+    // Create datastructure for calculating connections.
+    Triangulation* tri = new Triangulation(MapInfo.Rooms.size());
+    
+    // Get a vector of all the rooms centre position.
+    UMapBuilderLib::GetRoomCenters(MapInfo, tri->point);
+    
+    // Perform Delaunay triangulation to connect all the rooms.
+    QuadraticAlgorithm qa;
+    qa.triangulate(*tri);
+    
+    return tri;
+}
+
+list<int32>* UMapBuilderLib::CalcMinSpan(MapInfoType& MapInfo, Triangulation& tri)
+{
+    
+    // Generate a list of the minimum edges required to connect all the rooms.
+    // Large maps use the parallel Boruvka search, both produce the same tree.
+    list<int32>* minSpan;
+    if(tri.nPoints >= Boruvka::MinParallelVertices)
+    {
+        minSpan = Boruvka::runBoruvka(tri.point, tri.edge);
+    }
+    else
+    {
+        minSpan = Kruskal::runKruskal(tri.point, tri.edge);
+    }
+    MapInfo.MinConnectedCorridors = minSpan->size();
+    
+    return minSpan;
+}
+
+DynamicMinSpan* UMapBuilderLib::CreateDynamicMinSpan(MapInfoType& MapInfo, Triangulation& tri, list<int32>& minSpan)
+{
+    // CalcMinSpan moved the tree edges out of the triangulation, so rebuild the full edge set.
+    int32 treeLen = MapInfo.MinConnectedCorridors / 2;
+    vector<Edge> treeEdges(treeLen);
+    vector<Edge*> edges;
+    edges.reserve(treeLen + tri.edge.size());
+    
+    list<int32>::iterator itr = minSpan.begin();
+    for(int32 i = 0; i < treeLen; i++)
+    {
+        treeEdges[i].s = *(itr++);
+        treeEdges[i].t = *(itr++);
+        edges.push_back(&treeEdges[i]);
+    }
+    edges.insert(edges.end(), tri.edge.begin(), tri.edge.end());
+    
+    return new DynamicMinSpan(tri.point, edges);
+}
+
+void UMapBuilderLib::RemoveRoom(MapInfoType& MapInfo, DynamicMinSpan& span, int32 RoomIndex, list<int32>* Replacements)
+{
+    // The room stays in place so the indices used by the graph remain valid.
+    MapInfo.Rooms[RoomIndex]->Enabled = false;
+    span.RemoveVertex(RoomIndex, Replacements);
+}
+
+// Number of tree edges between every pair of rooms joined by a candidate edge, using binary lifting over the spanning tree.
+static void TreePathLengths(int32 nVerts, list<int32>& minSpan, int32 treeLen, vector<Edge*>& edges, vector<int32>& hops)
+{
+    vector<vector<int32> > adjacent(nVerts);
+    list<int32>::iterator itr = minSpan.begin();
+    for(int32 i = 0; i < treeLen; i++)
+    {
+        int32 u = *(itr++);
+        int32 v = *(itr++);
+        adjacent[u].push_back(v);
+        adjacent[v].push_back(u);
+    }
+    
+    int32 logV = 1;
+    while((1 << logV) < nVerts) logV++;
+    
+    vector<int32> depth(nVerts, -1);
+    vector<int32> tree(nVerts, -1);
+    vector<vector<int32> > up(logV, vector<int32>(nVerts));
+    vector<int32> stack;
+    for(int32 root = 0; root < nVerts; root++)
+    {
+        if(depth[root] != -1) continue;
+        
+        depth[root] = 0;
+        tree[root] = root;
+        up[0][root] = root;
+        stack.push_back(root);
+        while(!stack.empty())
+        {
+            int32 u = stack.back();
+            stack.pop_back();
+            for(int32 v : adjacent[u])
+            {
+                if(depth[v] != -1) continue;
+                depth[v] = depth[u] + 1;
+                tree[v] = root;
+                up[0][v] = u;
+                stack.push_back(v);
+            }
+        }
+    }
+    for(int32 k = 1; k < logV; k++)
+    {
+        for(int32 v = 0; v < nVerts; v++)
+        {
+            up[k][v] = up[k-1][up[k-1][v]];
+        }
+    }
+    
+    int32 len = edges.size();
+    hops.assign(len, 0);
+    for(int32 i = 0; i < len; i++)
+    {
+        int32 a = edges[i]->s;
+        int32 b = edges[i]->t;
+        if(tree[a] != tree[b])
+        {
+            // Joins two separate trees, no loop at all.
+            hops[i] = 0;
+            continue;
+        }
+        
+        int32 total = depth[a] + depth[b];
+        if(depth[a] < depth[b]) swap(a, b);
+        for(int32 k = logV - 1; k >= 0; k--)
+        {
+            if(depth[a] - (1 << k) >= depth[b]) a = up[k][a];
+        }
+        for(int32 k = logV - 1; k >= 0 && a != b; k--)
+        {
+            if(up[k][a] != up[k][b])
+            {
+                a = up[k][a];
+                b = up[k][b];
+            }
+        }
+        if(a != b) a = up[0][a];
+        
+        hops[i] = total - 2 * depth[a];
+    }
+}
+
+void UMapBuilderLib::AddRandomEdges(MapInfoType& MapInfo, Triangulation& tri, list<int32>& minSpan, CorridorWeighting Weighting)
+{
+    int32 len = tri.edge.size();
+    
+    // Weight every remaining edge, unused triangulation slots (s == t) can never be drawn.
+    vector<double> weights(len, 0.0);
+    vector<int32> hops;
+    if(Weighting == LongLoopWeighting)
+    {
+        TreePathLengths(tri.nPoints, minSpan, MapInfo.MinConnectedCorridors / 2, tri.edge, hops);
+    }
+    
+    for(int32 i = 0; i < len; i++)
+    {
+        Edge* e = tri.edge[i];
+        if(e->s == e->t) continue;
+        
+        switch(Weighting)
+        {
+            case ShortEdgeWeighting:
+                weights[i] = 1.0 / (1.0 + sqrt(Kruskal::metric_dist(*tri.point[e->s], *tri.point[e->t])));
+                break;
+            case LongLoopWeighting:
+                // A new corridor closes a loop one longer than the tree path it bypasses.
+                weights[i] = hops[i] + 1;
+                break;
+            default:
+                weights[i] = 1.0;
+                break;
+        }
+    }
+    
+    // Add some edges at random (this will allow for loops etc.)
+    WeightedSampler sampler(weights);
+    int32 count = min(MapInfo.MaxRandomCorridors, sampler.count());
+    
+    CounterRand rng(MapInfo.Seed, RandomEdgeStream);
+    
+    for(int32 i = 0; i < count; i++)
+    {
+        int32 index = sampler.draw(rng.NextDouble());
+        minSpan.push_back(tri.edge[index]->s);
+        minSpan.push_back(tri.edge[index]->t);
+    }
+}
+
+void UMapBuilderLib::CreateCorridorsBetween(MapInfoType& MapInfo, int32 Room1Index, int32 Room2Index)
+{
+    Room* room1 = MapInfo.Rooms[Room1Index];
+    Room* room2 = MapInfo.Rooms[Room2Index];
+    
+    // Find where the line between the two room centers leaves each room.
+    CorridorEndpoints ends(2);
+    ends.Set(0, room1->Bounds, room2->Bounds);
+    ends.Set(1, room2->Bounds, room1->Bounds);
+    ends.Solve();
+    
+    MapInfo.Corridors.push_back(UMapBuilderLib::MakeCorridor(ends, 0));
+}
+
+void UMapBuilderLib::GenerateCorridors(MapInfoType& MapInfo, list<int32>& edges, CorridorRouting Routing, int32 Threads)
+{
+    // Both ends of every corridor are solved in one batch, two entries per edge.
+    int32 count = edges.size() / 2;
+    CorridorEndpoints ends(count * 2);
+    
+    int32 i = 0;
+    for(list<int32>::iterator itr = edges.begin(); itr != edges.end(); itr++)
+    {
+        // Each edge element contains an index to a point element in the triangulation point list, which in turn should match up to its source Room index in MapInfo
+        int32 room1Ind = (*(itr));
+        itr++;
+        int32 room2Ind = (*(itr));
+        
+        ends.Set(i * 2, MapInfo.Rooms[room1Ind]->Bounds, MapInfo.Rooms[room2Ind]->Bounds);
+        ends.Set(i * 2 + 1, MapInfo.Rooms[room2Ind]->Bounds, MapInfo.Rooms[room1Ind]->Bounds);
+        i++;
+    }
+    
+    ends.Solve();
+    
+    if(Routing == StraightRouting)
+    {
+        // Generate a corridor for each edge in the edges list.
+        MapInfo.Corridors.reserve(MapInfo.Corridors.size() + count);
+        for(i = 0; i < count; i++)
+        {
+            MapInfo.Corridors.push_back(UMapBuilderLib::MakeCorridor(ends, i * 2));
+        }
+        return;
+    }
+    
+    // Route on several threads against the corridors that already exist. Each thread fills
+    // its own buffer from a contiguous run of edges, so appending the buffers in thread
+    // order keeps edge order whatever the thread count.
+    CorridorRouter router(MapInfo);
+    if(Threads <= 0) Threads = Parallel::ThreadCount();
+    vector<vector<Corridor*> > buffers(Threads);
+    
+    Parallel::For(0, count, [&](int32 begin, int32 end, int32 thread)
+    {
+        RouteWorkspace work;
+        for(int32 e = begin; e < end; e++)
+        {
+            Corridor* c = UMapBuilderLib::MakeCorridor(ends, e * 2);
+            router.RouteCorridor(*c, work, Routing, false);
+            buffers[thread].push_back(c);
+        }
+    }, Threads);
+    
+    int32 first = MapInfo.Corridors.size();
+    MapInfo.Corridors.reserve(first + count);
+    for(const vector<Corridor*>& buffer : buffers)
+    {
+        MapInfo.Corridors.insert(MapInfo.Corridors.end(), buffer.begin(), buffer.end());
+    }
+    
+    // Corridors routed over each other are settled one at a time in edge order.
+    RouteWorkspace work;
+    router.ResolveOverlaps(MapInfo.Corridors, first, work, Routing);
+}
+
+Corridor* UMapBuilderLib::MakeCorridor(CorridorEndpoints& ends, int32 Index)
+{
+    // Calculate starting and ending x,y corrds  for corridor.
+    Corridor* c = new Corridor();
+    c->SX = ends.OutX[Index];
+    c->SY = ends.OutY[Index];
+    c->EX = ends.OutX[Index + 1];
+    c->EY = ends.OutY[Index + 1];
+    c->Path.push_back(IPoint(c->SX, c->SY));
+    c->Path.push_back(IPoint(c->EX, c->EY));
+    c->UpdateBounds();
+    return c;
+}
+
+// Every cell a corridor covers, in order from start to end.
+static void corridorCells(const Corridor& c, vector<IPoint>& cells)
+{
+    cells.clear();
+    int32 len = c.Path.size();
+    for(int32 i = 1; i < len; i++)
+    {
+        const IPoint& a = c.Path[i - 1];
+        const IPoint& b = c.Path[i];
+        int32 dx = b.X - a.X;
+        int32 dy = b.Y - a.Y;
+        int32 steps = max(abs(dx), abs(dy));
+        
+        // Straight corridors that are not axis aligned are stepped along their longer axis.
+        for(int32 k = (i == 1) ? 0 : 1; k <= steps; k++)
+        {
+            int32 x = a.X + (int32)round((double)dx * k / max(steps, 1));
+            int32 y = a.Y + (int32)round((double)dy * k / max(steps, 1));
+            cells.push_back(IPoint(x, y));
+        }
+    }
+}
+
+void UMapBuilderLib::PlaceDoors(MapInfoType& MapInfo)
+{
+    deleteContainerContents(MapInfo.Doors);
+    
+    // Rooms first, then corridor features, in one hierarchy.
+    int32 nRooms = MapInfo.Rooms.size();
+    vector<IRect> boxes;
+    boxes.reserve(nRooms + MapInfo.CorridorFeatures.size());
+    for(Room* r : MapInfo.Rooms)
+    {
+        boxes.push_back(r->Bounds);
+    }
+    for(CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        boxes.push_back(f->Bounds);
+    }
+    BVH bvh(boxes);
+    
+    // Doors into rooms start closed, doors into corridor features are open archways.
+    DoorType roomDoor = { false, false, false, false };
+    DoorType featureDoor = { true, false, false, false };
+    
+    unordered_set<uint64_t> placed[walls];
+    vector<IPoint> cells;
+    vector<int32> candidates;
+    vector<int32> found;
+    
+    for(Corridor* c : MapInfo.Corridors)
+    {
+        corridorCells(*c, cells);
+        
+        // Only boxes near one of the corridor's segments can be crossed by it.
+        candidates.clear();
+        for(size_t i = 1; i < c->Path.size(); i++)
+        {
+            const IPoint& a = c->Path[i - 1];
+            const IPoint& b = c->Path[i];
+            IRect segment(min(a.X, b.X), min(a.Y, b.Y), abs(b.X - a.X), abs(b.Y - a.Y));
+            bvh.Query(segment, found);
+            candidates.insert(candidates.end(), found.begin(), found.end());
+        }
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+        
+        int32 nCells = cells.size();
+        for(int32 k : candidates)
+        {
+            const IRect& box = boxes[k];
+            for(int32 i = 0; i < nCells; i++)
+            {
+                const IPoint& p = cells[i];
+                if(!box.Contains(p) || (p.X > box.Left() && p.X < box.Right() && p.Y > box.Top() && p.Y < box.Bottom()))
+                {
+                    continue;
+                }
+                
+                // A wall cell is a door when the corridor is outside the box on exactly one side of it,
+                // running along a wall or brushing past a corner is not a crossing.
+                bool prevOut = (i > 0) && !box.Contains(cells[i - 1]);
+                bool nextOut = (i + 1 < nCells) && !box.Contains(cells[i + 1]);
+                if(prevOut == nextOut) continue;
+                
+                const IPoint& outside = prevOut ? cells[i - 1] : cells[i + 1];
+                int32 wall = (outside.X < box.Left()) ? LeftWall :
+                             (outside.X > box.Right()) ? RightWall :
+                             (outside.Y < box.Top()) ? TopWall : BottomWall;
+                
+                if(k < nRooms)
+                {
+                    Room* room = MapInfo.Rooms[k];
+                    if(find(room->Corridors.begin(), room->Corridors.end(), c) == room->Corridors.end())
+                    {
+                        room->Corridors.push_back(c);
+                    }
+                }
+                
+                // Corridors that merge share the door of the first one through. Corridors leaving
+                // a corner cell through different walls each need their own.
+                uint64_t key = ((uint64_t)(uint32_t)p.X << 32) | (uint32_t)p.Y;
+                if(!placed[wall].insert(key).second) continue;
+                
+                Door* door = new Door(p.X, p.Y, wall, (k < nRooms) ? roomDoor : featureDoor);
+                door->LinkedCorridor = c;
+                if(k < nRooms)
+                {
+                    door->LinkedRoom = MapInfo.Rooms[k];
+                }
+                else
+                {
+                    door->LinkedFeature = MapInfo.CorridorFeatures[k - nRooms];
+                }
+                MapInfo.Doors.push_back(door);
+            }
+        }
+    }
+}
+
+// True if any cell of the segment from a to b lies in box.
+static bool segmentCrosses(const IPoint& a, const IPoint& b, const IRect& box)
+{
+    int32 dx = b.X - a.X;
+    int32 dy = b.Y - a.Y;
+    if(dx == 0 || dy == 0)
+    {
+        // Axis aligned, overlapping boxes is enough.
+        return min(a.X, b.X) <= box.Right() && max(a.X, b.X) >= box.Left() &&
+               min(a.Y, b.Y) <= box.Bottom() && max(a.Y, b.Y) >= box.Top();
+    }
+    
+    int32 steps = max(abs(dx), abs(dy));
+    for(int32 k = 0; k <= steps; k++)
+    {
+        int32 x = a.X + (int32)round((double)dx * k / steps);
+        int32 y = a.Y + (int32)round((double)dy * k / steps);
+        if(box.Contains(x, y)) return true;
+    }
+    return false;
+}
+
+void UMapBuilderLib::LinkCorridorFeatures(MapInfoType& MapInfo)
+{
+    vector<IRect> boxes;
+    boxes.reserve(MapInfo.CorridorFeatures.size());
+    for(CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        f->LinkedCorridor = 0;
+        f->Corridors.clear();
+        boxes.push_back(f->Bounds);
+    }
+    BVH bvh(boxes);
+    
+    vector<int32> found;
+    vector<int32> crossed;
+    for(Corridor* c : MapInfo.Corridors)
+    {
+        c->Features.clear();
+        c->UpdateBounds();
+        
+        crossed.clear();
+        for(size_t i = 1; i < c->Path.size(); i++)
+        {
+            const IPoint& a = c->Path[i - 1];
+            const IPoint& b = c->Path[i];
+            bvh.Query(IRect(min(a.X, b.X), min(a.Y, b.Y), abs(b.X - a.X), abs(b.Y - a.Y)), found);
+            for(int32 k : found)
+            {
+                if(segmentCrosses(a, b, boxes[k]))
+                {
+                    crossed.push_back(k);
+                }
+            }
+        }
+        sort(crossed.begin(), crossed.end());
+        crossed.erase(unique(crossed.begin(), crossed.end()), crossed.end());
+        
+        int32 left = c->Bounds.Left(), top = c->Bounds.Top();
+        int32 right = c->Bounds.Right(), bottom = c->Bounds.Bottom();
+        for(int32 k : crossed)
+        {
+            CorridorFeature* f = MapInfo.CorridorFeatures[k];
+            f->Corridors.push_back(c);
+            
+            // The first corridor through a feature takes it over and grows to cover it.
+            if(f->LinkedCorridor == 0)
+            {
+                f->LinkedCorridor = c;
+                c->Features.push_back(f);
+                left = min(left, f->Bounds.Left());
+                top = min(top, f->Bounds.Top());
+                right = max(right, f->Bounds.Right());
+                bottom = max(bottom, f->Bounds.Bottom());
+            }
+        }
+        c->Bounds = IRect(left, top, right - left, bottom - top);
+    }
+}
+
+void UMapBuilderLib::ConnectPoints(MapInfoType& MapInfo, const vector<IPoint>& Points, CorridorRouting Routing)
+{
+    if(MapInfo.Rooms.empty()) return;
+    
+    CorridorRouter router(MapInfo);
+    RouteWorkspace work;
+    for(const IPoint& p : Points)
+    {
+        // Join the point to the nearest wall cell of the nearest room.
+        IPoint target;
+        int32 best = -1;
+        for(Room* r : MapInfo.Rooms)
+        {
+            IPoint wall(min(max(p.X, r->Bounds.Left()), r->Bounds.Right()), min(max(p.Y, r->Bounds.Top()), r->Bounds.Bottom()));
+            int32 distance = abs(wall.X - p.X) + abs(wall.Y - p.Y);
+            if(best == -1 || distance < best)
+            {
+                best = distance;
+                target = wall;
+            }
+        }
+        
+        Corridor* c = new Corridor();
+        c->SX = p.X;
+        c->SY = p.Y;
+        c->EX = target.X;
+        c->EY = target.Y;
+        router.RouteCorridor(*c, work, Routing);
+        MapInfo.Corridors.push_back(c);
+    }
+}
+
+void UMapBuilderLib::GenerateMap(MapInfoType& MapInfo, const GenerationParams& Params, int32 Seed, const vector<IPoint>* Connectors,
+                                 const vector<RoomFilter*>* Filters)
+{
+    UMapBuilderLib::InitMap(MapInfo, Params.Width, Params.Height);
+    MapInfo.setRoomSizeLimits(Params.MinRoomWidth, Params.MaxRoomWidth, Params.MinRoomHeight, Params.MaxRoomHeight);
+    MapInfo.setGenerationLimits(Params.MaxRooms, Params.MaxRandomCorridors);
+    UMapBuilderLib::SetSeed(MapInfo, Seed);
+    UMapBuilderLib::MakeRooms(MapInfo, Params.RoomCount, Params.MinRoomLength, Params.MaxRoomLength,
+                              Params.Width / 2, Params.Height / 2, Params.Spread, Params.Spread);
+    
+    // The same steps main.cpp takes one frame at a time.
+    UMapBuilderLib::RemoveRoomsBelowRatio(MapInfo, Params.MinRatio);
+    for(int32 i = 0; i < Params.MaxSeparateSteps; i++)
+    {
+        if(UMapBuilderLib::SeparateRooms(MapInfo)) break;
+    }
+    
+    // Rooms pushed out to the edge of the map are dropped, leaving the border free for connectors.
+    int32 len = MapInfo.Rooms.size();
+    int32 i = 0;
+    while(i < len)
+    {
+        const IRect& b = MapInfo.Rooms[i]->Bounds;
+        if(b.Left() < Params.Margin || b.Top() < Params.Margin ||
+           b.Right() >= Params.Width - Params.Margin || b.Bottom() >= Params.Height - Params.Margin)
+        {
+            delete MapInfo.Rooms[i];
+            MapInfo.Rooms.erase(MapInfo.Rooms.begin() + i);
+            len--;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    
+    // Filters keep the rooms they cover once the rooms are spread out, as main.cpp applies them.
+    if(Filters != nullptr && !Filters->empty())
+    {
+        for(RoomFilter* f : *Filters)
+        {
+            UMapBuilderLib::FilterRooms(MapInfo, *f);
+        }
+        UMapBuilderLib::RemoveFiltered(MapInfo);
+    }
+    
+    UMapBuilderLib::SeparateCorridorFeatures(MapInfo);
+    UMapBuilderLib::ReduceRooms(MapInfo);
+    
+    // The triangulation needs three rooms, fewer are simply joined in a line.
+    list<int32> edges;
+    if(MapInfo.Rooms.size() >= 3)
+    {
+        Triangulation* tri = UMapBuilderLib::PerformDelaunayTriangulation(MapInfo);
+        list<int32>* minSpan = UMapBuilderLib::CalcMinSpan(MapInfo, *tri);
+        UMapBuilderLib::AddRandomEdges(MapInfo, *tri, *minSpan, Params.Weighting);
+        edges.swap(*minSpan);
+        delete minSpan;
+        delete tri;
+    }
+    else if(MapInfo.Rooms.size() == 2)
+    {
+        edges.push_back(0);
+        edges.push_back(1);
+    }
+    UMapBuilderLib::GenerateCorridors(MapInfo, edges, Params.Routing);
+    
+    if(Connectors != nullptr)
+    {
+        UMapBuilderLib::ConnectPoints(MapInfo, *Connectors, Params.Routing == StraightRouting ? AStarRouting : Params.Routing);
+    }
+    
+    UMapBuilderLib::PlaceDoors(MapInfo);
+    UMapBuilderLib::LinkCorridorFeatures(MapInfo);
+    
+    // Straight corridors step diagonally and can leave rooms cut off, join them up again.
+    ConnectivityReport report;
+    MapValidator::Validate(MapInfo, report, Params.Routing == StraightRouting ? AStarRouting : Params.Routing);
 }
\ No newline at end of file
@@ -1,40 +1,85 @@
-#pragma once
-
-#include <stdlib.h>
-#include <vector>
-#include <list>
-#include "MapModel.h"
-#include "RoomFilter.h"
-#include "FPoint.h"
-#include "Delaunay.h"
-#include "Helper.h"
-
-//UCLASS()
-class UMapBuilderLib //: public UBlueprintFunctionLibrary
-{
-    //GENERATED_UCLASS_BODY()
-public:
-    static void InitMap(MapInfoType& MapInfo, int32 Width, int32 Height);
-    static void ClearMap(MapInfoType& MapInfo);
-    
-    static void SetSeed(MapInfoType& MapInfo, int32 Seed) { MapInfo.Seed = Seed; }
-    static int32 SetRandomSeed(MapInfoType& MapInfo) { MapInfo.Seed = rand(); return MapInfo.Seed; }
-    
-    static void MakeRooms(MapInfoType& MapInfo, int32 Num, int32 minLen, int32 maxLen, int32 XOrigin, int32 YOrigin, int32 WidthMargin = 0, int32 HeightMargin = 0);
-    static bool SeparateRooms(MapInfoType& MapInfo);
-    static void RemoveRoomsBelowRatio(MapInfoType& MapInfo, float ratio);
-    static void FilterRooms(MapInfoType& MapInfo, RoomFilter& rf);
-    static void RemoveFiltered(MapInfoType& MapInfo);
-    static void GetRoomCenters(MapInfoType& MapInfo, std::vector<FPoint*>& point);
-    static void ReduceRooms(MapInfoType& MapInfo);
-    static void SeparateCorridorFeatures(MapInfoType& MapInfo);
-    static Triangulation* PerformDelaunayTriangulation(MapInfoType& MapInfo);
-    static std::list<int32>* CalcMinSpan(MapInfoType& MapInfo, Triangulation& tri);
-    static void AddRandomEdges(MapInfoType& MapInfo, Triangulation& tri, std::list<int32>& minSpan);
-    static void GenerateCorridors(MapInfoType& MapInfo, std::list<int32>& edges);
-    static void CreateCorridorsBetween(MapInfoType& MapInfo, int32 Room1Index, int32 Room2Index);
-    
-private:
-    static int32 DetermineX(Room& r, double ang);
-    static int32 DetermineY(Room& r, double ang);
+#pragma once
+
+#include <stdlib.h>
+#include <vector>
+#include <list>
+#include "MapModel.h"
+#include "RoomFilter.h"
+#include "FPoint.h"
+#include "Delaunay.h"
+#include "DynamicMinSpan.h"
+#include "CorridorEndpoints.h"
+#include "CorridorRouter.h"
+#include "Helper.h"
+
+/** Raised whenever a change to the pipeline changes the maps it makes for the same settings, so cached maps are not reused. **/
+static const uint32_t MapPipelineVersion = 3;
+
+/** How AddRandomEdges favours the extra corridors it adds. **/
+enum CorridorWeighting
+{
+    UniformWeighting,   /** Every remaining edge is equally likely. **/
+    ShortEdgeWeighting, /** Likelihood falls with corridor length. **/
+    LongLoopWeighting   /** Likelihood grows with the length of the loop the corridor closes. **/
+};
+
+/** Settings for running the whole generation pipeline in one call. **/
+typedef struct
+{
+    int32 Width;
+    int32 Height;
+    
+    int32 RoomCount;            /** Rooms made before any are removed. **/
+    int32 MinRoomLength;
+    int32 MaxRoomLength;
+    int32 Spread;               /** Rooms start within this distance of the map centre. **/
+    int32 Margin;               /** Rooms closer than this to the map edge are removed. **/
+    int32 MaxSeparateSteps;     /** SeparateRooms passes before giving up on overlaps. **/
+    float MinRatio;             /** Rooms thinner than this are removed. **/
+    
+    int32 MinRoomWidth;
+    int32 MaxRoomWidth;
+    int32 MinRoomHeight;
+    int32 MaxRoomHeight;
+    int32 MaxRooms;
+    int32 MaxRandomCorridors;
+    
+    CorridorRouting Routing;
+    CorridorWeighting Weighting;
+} GenerationParams;
+
+//UCLASS()
+class UMapBuilderLib //: public UBlueprintFunctionLibrary
+{
+    //GENERATED_UCLASS_BODY()
+public:
+    static void InitMap(MapInfoType& MapInfo, int32 Width, int32 Height);
+    static void ClearMap(MapInfoType& MapInfo);
+    
+    static void SetSeed(MapInfoType& MapInfo, int32 Seed) { MapInfo.Seed = Seed; }
+    static int32 SetRandomSeed(MapInfoType& MapInfo) { MapInfo.Seed = rand(); return MapInfo.Seed; }
+    
+    static void MakeRooms(MapInfoType& MapInfo, int32 Num, int32 minLen, int32 maxLen, int32 XOrigin, int32 YOrigin, int32 WidthMargin = 0, int32 HeightMargin = 0);
+    static bool SeparateRooms(MapInfoType& MapInfo);
+    static void RemoveRoomsBelowRatio(MapInfoType& MapInfo, float ratio);
+    static void FilterRooms(MapInfoType& MapInfo, RoomFilter& rf);
+    static void RemoveFiltered(MapInfoType& MapInfo);
+    static void GetRoomCenters(MapInfoType& MapInfo, std::vector<FPoint*>& point);
+    static void ReduceRooms(MapInfoType& MapInfo);
+    static void SeparateCorridorFeatures(MapInfoType& MapInfo);
+    static Triangulation* PerformDelaunayTriangulation(MapInfoType& MapInfo);
+    static std::list<int32>* CalcMinSpan(MapInfoType& MapInfo, Triangulation& tri);
+    static DynamicMinSpan* CreateDynamicMinSpan(MapInfoType& MapInfo, Triangulation& tri, std::list<int32>& minSpan);
+    static void RemoveRoom(MapInfoType& MapInfo, DynamicMinSpan& span, int32 RoomIndex, std::list<int32>* Replacements = nullptr);
+    static void AddRandomEdges(MapInfoType& MapInfo, Triangulation& tri, std::list<int32>& minSpan, CorridorWeighting Weighting = UniformWeighting);
+    static void GenerateCorridors(MapInfoType& MapInfo, std::list<int32>& edges, CorridorRouting Routing = StraightRouting, int32 Threads = 0);
+    static void CreateCorridorsBetween(MapInfoType& MapInfo, int32 Room1Index, int32 Room2Index);
+    static void PlaceDoors(MapInfoType& MapInfo);
+    static void LinkCorridorFeatures(MapInfoType& MapInfo);
+    static void ConnectPoints(MapInfoType& MapInfo, const std::vector<IPoint>& Points, CorridorRouting Routing = AStarRouting);
+    static void GenerateMap(MapInfoType& MapInfo, const GenerationParams& Params, int32 Seed, const std::vector<IPoint>* Connectors = nullptr,
+                            const std::vector<RoomFilter*>* Filters = nullptr);
+    
+private:
+    static Corridor* MakeCorridor(CorridorEndpoints& ends, int32 Index);
 };
\ No newline at end of file
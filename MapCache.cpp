@@ -0,0 +1,305 @@
+#include "MapCache.h"
+#include "MapFile.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char* mapSuffix = ".map";
+static const char* tempSuffix = ".tmp";
+
+// Temporary files older than this were left by a process that died while storing.
+static const time_t staleSeconds = 3600;
+
+// Temporary file names taken by this process.
+static atomic<uint32_t> tempCount(0);
+
+typedef struct
+{
+    string Name;
+    uint64_t Bytes;
+    double Used;    // Seconds since the epoch the map was last stored or loaded.
+} CacheFile;
+
+static bool endsWith(const string& Name, const char* Suffix)
+{
+    size_t n = strlen(Suffix);
+    return Name.size() >= n && Name.compare(Name.size() - n, n, Suffix) == 0;
+}
+
+static double modifiedTime(const struct stat& Info)
+{
+#if defined(__APPLE__)
+    return Info.st_mtimespec.tv_sec + Info.st_mtimespec.tv_nsec * 1e-9;
+#elif defined(_WIN32)
+    return (double)Info.st_mtime;
+#else
+    return Info.st_mtim.tv_sec + Info.st_mtim.tv_nsec * 1e-9;
+#endif
+}
+
+// Mark a map as just used, for eviction order.
+static void touch(const string& Path)
+{
+#ifdef _WIN32
+    FILE* file = fopen(Path.c_str(), "r+b");
+    if(file != 0)
+    {
+        // Rewriting the first byte updates the modified time.
+        int c = fgetc(file);
+        if(c != EOF)
+        {
+            fseek(file, 0, SEEK_SET);
+            fputc(c, file);
+        }
+        fclose(file);
+    }
+#else
+    utimes(Path.c_str(), 0);
+#endif
+}
+
+// Every map and temporary file in Directory.
+static void listFiles(const string& Directory, vector<CacheFile>& Files)
+{
+#ifdef _WIN32
+    _finddata_t found;
+    intptr_t search = _findfirst((Directory + "/*").c_str(), &found);
+    if(search == -1) return;
+    do
+    {
+        string name = found.name;
+#else
+    DIR* dir = opendir(Directory.c_str());
+    if(dir == 0) return;
+    while(dirent* entry = readdir(dir))
+    {
+        string name = entry->d_name;
+#endif
+        if(!endsWith(name, mapSuffix) && !endsWith(name, tempSuffix)) continue;
+        
+        struct stat info;
+        if(stat((Directory + "/" + name).c_str(), &info) != 0) continue;
+        
+        CacheFile file = { name, (uint64_t)info.st_size, modifiedTime(info) };
+        Files.push_back(file);
+#ifdef _WIN32
+    } while(_findnext(search, &found) == 0);
+    _findclose(search);
+#else
+    }
+    closedir(dir);
+#endif
+}
+
+MapCache::MapCache(const string& Directory, uint64_t MaxBytes)
+{
+    directory = Directory;
+    maxBytes = MaxBytes;
+    hits = 0;
+    misses = 0;
+    
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0777);
+#endif
+}
+
+uint64_t MapCache::Key(const GenerationParams& Params, int32 Seed, const vector<RoomFilter*>* Filters, const vector<IPoint>* Connectors)
+{
+    // Each field on its own, so padding and field order in memory do not matter.
+    uint32_t ratio;
+    memcpy(&ratio, &Params.MinRatio, sizeof(ratio));
+    const uint64_t fields[] =
+    {
+        MapPipelineVersion, MapFileVersion, (uint32_t)Seed,
+        (uint32_t)Params.Width, (uint32_t)Params.Height,
+        (uint32_t)Params.RoomCount, (uint32_t)Params.MinRoomLength, (uint32_t)Params.MaxRoomLength,
+        (uint32_t)Params.Spread, (uint32_t)Params.Margin, (uint32_t)Params.MaxSeparateSteps, ratio,
+        (uint32_t)Params.MinRoomWidth, (uint32_t)Params.MaxRoomWidth, (uint32_t)Params.MinRoomHeight, (uint32_t)Params.MaxRoomHeight,
+        (uint32_t)Params.MaxRooms, (uint32_t)Params.MaxRandomCorridors,
+        (uint32_t)Params.Routing, (uint32_t)Params.Weighting
+    };
+    
+    uint64_t key = HashSeed;
+    for(uint64_t field : fields)
+    {
+        key = HashCombine(key, field);
+    }
+    
+    // Filters are applied in order, so their order is part of the key.
+    if(Filters != nullptr)
+    {
+        for(const RoomFilter* filter : *Filters)
+        {
+            key = HashCombine(key, filter->Key());
+        }
+    }
+    
+    // Connectors are joined in order too. None and an empty list make the same map.
+    if(Connectors != nullptr && !Connectors->empty())
+    {
+        key = HashCombine(key, Connectors->size());
+        for(const IPoint& p : *Connectors)
+        {
+            key = HashCombine(key, ((uint64_t)(uint32_t)p.X << 32) | (uint32_t)p.Y);
+        }
+    }
+    return key;
+}
+
+string MapCache::PathOf(uint64_t Key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)Key);
+    return directory + "/" + name + mapSuffix;
+}
+
+bool MapCache::Load(uint64_t Key, MapInfoType& MapInfo)
+{
+    string path = PathOf(Key);
+    MappedMap file;
+    if(!file.Open(path)) return false;
+    
+    file.ToMapInfo(MapInfo);
+    touch(path);
+    return true;
+}
+
+bool MapCache::Store(uint64_t Key, const MapInfoType& MapInfo, const list<int32>* Edges, const TileGrid* Tiles)
+{
+    // A name no other process or thread is using.
+#ifdef _WIN32
+    int32 process = _getpid();
+#else
+    int32 process = getpid();
+#endif
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), ".%d.%u%s", process, (unsigned)tempCount++, tempSuffix);
+    string path = PathOf(Key);
+    string temp = path + suffix;
+    
+    if(!MapFile::Save(temp, MapInfo, Edges, Tiles))
+    {
+        remove(temp.c_str());
+        return false;
+    }
+    
+    // Replaces any copy another process stored meanwhile, readers of that copy keep their view of it.
+    // Windows will not rename over an existing file, but that file then already holds the same map.
+    if(rename(temp.c_str(), path.c_str()) != 0)
+    {
+        remove(temp.c_str());
+        struct stat info;
+        if(stat(path.c_str(), &info) != 0) return false;
+    }
+    
+    Trim(path.substr(directory.size() + 1));
+    return true;
+}
+
+bool MapCache::Fetch(MapInfoType& MapInfo, const GenerationParams& Params, int32 Seed, const vector<RoomFilter*>* Filters,
+                     const vector<IPoint>* Connectors, const function<void(MapInfoType&)>& Generate)
+{
+    uint64_t key = Key(Params, Seed, Filters, Connectors);
+    if(Load(key, MapInfo))
+    {
+        // Settings GenerateMap records that the file does not hold.
+        MapInfo.setRoomSizeLimits(Params.MinRoomWidth, Params.MaxRoomWidth, Params.MinRoomHeight, Params.MaxRoomHeight);
+        MapInfo.setGenerationLimits(Params.MaxRooms, Params.MaxRandomCorridors);
+        hits++;
+        return true;
+    }
+    
+    misses++;
+    if(Generate)
+    {
+        Generate(MapInfo);
+    }
+    else
+    {
+        UMapBuilderLib::GenerateMap(MapInfo, Params, Seed, Connectors, Filters);
+    }
+    Store(key, MapInfo);
+    return false;
+}
+
+uint64_t MapCache::Bytes() const
+{
+    vector<CacheFile> files;
+    listFiles(directory, files);
+    
+    uint64_t bytes = 0;
+    for(const CacheFile& f : files)
+    {
+        bytes += f.Bytes;
+    }
+    return bytes;
+}
+
+void MapCache::Evict()
+{
+    Trim(string());
+}
+
+void MapCache::Trim(const string& Keep)
+{
+#ifndef _WIN32
+    // Held until closed. Without it two processes could both count the directory and evict twice as much.
+    int lock = open((directory + "/lock").c_str(), O_RDWR | O_CREAT, 0666);
+    if(lock >= 0)
+    {
+        flock(lock, LOCK_EX);
+    }
+#endif
+    
+    vector<CacheFile> files;
+    listFiles(directory, files);
+    
+    uint64_t bytes = 0;
+    double now = (double)time(0);
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        // Temporary files still being written are counted but never removed, unless long abandoned.
+        if(endsWith(files[i].Name, tempSuffix) && now - files[i].Used > staleSeconds)
+        {
+            remove((directory + "/" + files[i].Name).c_str());
+            files[i].Bytes = 0;
+        }
+        bytes += files[i].Bytes;
+    }
+    
+    sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.Used < b.Used; });
+    for(size_t i = 0; i < files.size() && bytes > maxBytes; i++)
+    {
+        if(!endsWith(files[i].Name, mapSuffix) || files[i].Name == Keep) continue;
+        
+        if(remove((directory + "/" + files[i].Name).c_str()) == 0)
+        {
+            bytes -= files[i].Bytes;
+        }
+    }
+    
+#ifndef _WIN32
+    if(lock >= 0)
+    {
+        close(lock);
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdint.h>
+#include "MapModel.h"
+#include "MapBuilderLib.h"
+#include "RoomFilter.h"
+#include "TileGrid.h"
+#include "Helper.h"
+
+/**
+ * Directory of finished maps in the MapFile format, keyed by a hash of
+ * everything that decides what the pipeline makes.
+ *
+ * A map is written under a temporary name and renamed into place, so other
+ * processes only ever see whole files, and a read maps the file, so it stays
+ * readable even if another process evicts it meanwhile. Stores trim the
+ * directory back under its size limit, least recently used maps first, while
+ * holding a lock file so two processes do not evict at the same time.
+ */
+class MapCache
+{
+public:
+    /** Cache in Directory, created if missing, holding at most MaxBytes of maps. **/
+    MapCache(const std::string& Directory, uint64_t MaxBytes);
+    
+    /**
+     * Key of the map GenerateMap makes from Params, Seed, Connectors and Filters, also covering
+     * MapPipelineVersion and MapFileVersion.
+     */
+    static uint64_t Key(const GenerationParams& Params, int32 Seed, const std::vector<RoomFilter*>* Filters = nullptr,
+                        const std::vector<IPoint>* Connectors = nullptr);
+    
+    /** Read the map stored under Key into MapInfo. Returns false, leaving MapInfo untouched, on a miss. **/
+    bool Load(uint64_t Key, MapInfoType& MapInfo);
+    
+    /** Store MapInfo under Key, then evict other maps down to the size limit. **/
+    bool Store(uint64_t Key, const MapInfoType& MapInfo, const std::list<int32>* Edges = nullptr, const TileGrid* Tiles = nullptr);
+    
+    /**
+     * Load the map for Params, Seed, Filters and Connectors, or on a miss make it and store it.
+     * The map is made by UMapBuilderLib::GenerateMap with the same arguments, or by Generate if
+     * one is given, which must then make that same map. Returns true on a hit.
+     */
+    bool Fetch(MapInfoType& MapInfo, const GenerationParams& Params, int32 Seed, const std::vector<RoomFilter*>* Filters = nullptr,
+               const std::vector<IPoint>* Connectors = nullptr,
+               const std::function<void(MapInfoType&)>& Generate = std::function<void(MapInfoType&)>());
+               
+    /** Remove least recently used maps until the directory holds at most MaxBytes. **/
+    void Evict();
+    
+    std::string PathOf(uint64_t Key) const;
+    uint64_t Bytes() const;
+    int32 Hits() const { return hits; }
+    int32 Misses() const { return misses; }
+    
+private:
+    std::string directory;
+    uint64_t maxBytes;
+    int32 hits;
+    int32 misses;
+    
+    // Evict, never removing the map file named Keep.
+    void Trim(const std::string& Keep);
+};
\ No newline at end of file
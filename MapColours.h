@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+/** An 8 bit per channel colour, laid out in memory as R, G, B, A. **/
+typedef struct
+{
+    uint8_t R, G, B, A;
+} MapColour;
+
+/** Colours every view of a map draws with, the SFML window and MapRenderer alike. **/
+static const MapColour BackgroundColour = { 0, 0, 0, 255 };
+static const MapColour RoomFillColour = { 255, 255, 255, 255 };
+static const MapColour RoomLineColour = { 255, 0, 0, 255 };
+static const MapColour CorridorFillColour = { 255, 255, 255, 255 };
+static const MapColour CorridorLineColour = { 0, 0, 255, 255 };
+static const MapColour DelaunayLineColour = { 255, 255, 0, 255 };
+static const MapColour FinalEdgeLineColour = { 0, 255, 255, 255 };
+static const MapColour DoorColour = { 255, 0, 255, 255 };
+static const MapColour RoomPointColour = { 0, 255, 0, 255 };
\ No newline at end of file
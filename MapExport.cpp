@@ -0,0 +1,380 @@
+#include "MapExport.h"
+#include <cstring>
+
+using namespace std;
+
+static const char* wallNames[walls] = { "top", "right", "bottom", "left" };
+
+void BufferedSink::Put(const char* Text, size_t Length)
+{
+    while(Length > 0)
+    {
+        if(used == sizeof(buffer)) Flush();
+        
+        size_t n = min(Length, sizeof(buffer) - used);
+        memcpy(buffer + used, Text, n);
+        used += n;
+        Text += n;
+        Length -= n;
+    }
+}
+
+void BufferedSink::Put(const char* Text)
+{
+    Put(Text, strlen(Text));
+}
+
+void BufferedSink::Put(int64_t Value)
+{
+    // Digits are produced last first, into the end of a small buffer.
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    uint64_t v = (Value < 0) ? 0 - (uint64_t)Value : (uint64_t)Value;
+    do
+    {
+        *--p = (char)('0' + v % 10);
+        v /= 10;
+    } while(v != 0);
+    
+    if(Value < 0) *--p = '-';
+    Put(p, end - p);
+}
+
+bool BufferedSink::Flush()
+{
+    if(used > 0 && !failed)
+    {
+        failed = (fwrite(buffer, 1, used, out) != used);
+    }
+    used = 0;
+    return !failed;
+}
+
+// Finish Out and close the file behind it, false if anything failed to write.
+static bool closeSink(BufferedSink& Out, FILE* File)
+{
+    bool written = Out.Flush();
+    return (fclose(File) == 0) && written;
+}
+
+static void putBool(BufferedSink& Out, bool Value)
+{
+    Out.Put(Value ? "true" : "false");
+}
+
+// Door type as space separated words, such as "open locked", or "closed".
+static void putDoorType(BufferedSink& Out, const DoorType& Type)
+{
+    Out.Put(Type.IsOpen ? "open" : "closed");
+    if(Type.IsLocked) Out.Put(" locked");
+    if(Type.IsDestructable) Out.Put(" destructable");
+    if(Type.IsHidden) Out.Put(" hidden");
+}
+
+static void putJsonRect(BufferedSink& Out, const IRect& Bounds)
+{
+    Out.Put("\"x\":");
+    Out.Put(Bounds.Position.X);
+    Out.Put(",\"y\":");
+    Out.Put(Bounds.Position.Y);
+    Out.Put(",\"width\":");
+    Out.Put(Bounds.Width);
+    Out.Put(",\"height\":");
+    Out.Put(Bounds.Height);
+}
+
+static void putJsonPoint(BufferedSink& Out, int32 x, int32 y)
+{
+    Out.Put('[');
+    Out.Put(x);
+    Out.Put(',');
+    Out.Put(y);
+    Out.Put(']');
+}
+
+void MapExport::WriteJson(BufferedSink& Out, const MapInfoType& MapInfo)
+{
+    Out.Put("{\n\"seed\":");
+    Out.Put(MapInfo.Seed);
+    Out.Put(",\n\"width\":");
+    Out.Put(MapInfo.Width);
+    Out.Put(",\n\"height\":");
+    Out.Put(MapInfo.Height);
+    
+    Out.Put(",\n\"rooms\":[");
+    for(size_t i = 0; i < MapInfo.Rooms.size(); i++)
+    {
+        Out.Put(i == 0 ? "\n{" : ",\n{");
+        putJsonRect(Out, MapInfo.Rooms[i]->Bounds);
+        Out.Put(",\"enabled\":");
+        putBool(Out, MapInfo.Rooms[i]->Enabled);
+        Out.Put('}');
+    }
+    
+    Out.Put("],\n\"features\":[");
+    for(size_t i = 0; i < MapInfo.CorridorFeatures.size(); i++)
+    {
+        Out.Put(i == 0 ? "\n{" : ",\n{");
+        putJsonRect(Out, MapInfo.CorridorFeatures[i]->Bounds);
+        Out.Put('}');
+    }
+    
+    Out.Put("],\n\"corridors\":[");
+    for(size_t i = 0; i < MapInfo.Corridors.size(); i++)
+    {
+        const Corridor* c = MapInfo.Corridors[i];
+        Out.Put(i == 0 ? "\n{\"start\":" : ",\n{\"start\":");
+        putJsonPoint(Out, c->SX, c->SY);
+        Out.Put(",\"end\":");
+        putJsonPoint(Out, c->EX, c->EY);
+        Out.Put(",\"path\":[");
+        for(size_t p = 0; p < c->Path.size(); p++)
+        {
+            if(p > 0) Out.Put(',');
+            putJsonPoint(Out, c->Path[p].X, c->Path[p].Y);
+        }
+        Out.Put("]}");
+    }
+    
+    Out.Put("],\n\"doors\":[");
+    for(size_t i = 0; i < MapInfo.Doors.size(); i++)
+    {
+        const Door* d = MapInfo.Doors[i];
+        Out.Put(i == 0 ? "\n{\"x\":" : ",\n{\"x\":");
+        Out.Put(d->X);
+        Out.Put(",\"y\":");
+        Out.Put(d->Y);
+        Out.Put(",\"wall\":\"");
+        Out.Put(wallNames[d->Wall & 3]);
+        Out.Put("\",\"open\":");
+        putBool(Out, d->Type.IsOpen);
+        Out.Put(",\"locked\":");
+        putBool(Out, d->Type.IsLocked);
+        Out.Put(",\"destructable\":");
+        putBool(Out, d->Type.IsDestructable);
+        Out.Put(",\"hidden\":");
+        putBool(Out, d->Type.IsHidden);
+        Out.Put('}');
+    }
+    Out.Put("]\n}\n");
+}
+
+// One CSV row up to and including the info column's separator.
+static void putCsvRow(BufferedSink& Out, const char* Kind, size_t Id, int32 x, int32 y, int32 Width, int32 Height)
+{
+    Out.Put(Kind);
+    Out.Put(',');
+    Out.Put((int64_t)Id);
+    Out.Put(',');
+    Out.Put(x);
+    Out.Put(',');
+    Out.Put(y);
+    Out.Put(',');
+    Out.Put(Width);
+    Out.Put(',');
+    Out.Put(Height);
+    Out.Put(',');
+}
+
+void MapExport::WriteCsv(BufferedSink& Out, const MapInfoType& MapInfo)
+{
+    Out.Put("kind,id,x,y,width,height,info\n");
+    
+    for(size_t i = 0; i < MapInfo.Rooms.size(); i++)
+    {
+        const IRect& b = MapInfo.Rooms[i]->Bounds;
+        putCsvRow(Out, "room", i, b.Position.X, b.Position.Y, b.Width, b.Height);
+        Out.Put(MapInfo.Rooms[i]->Enabled ? "enabled\n" : "disabled\n");
+    }
+    
+    for(size_t i = 0; i < MapInfo.CorridorFeatures.size(); i++)
+    {
+        const IRect& b = MapInfo.CorridorFeatures[i]->Bounds;
+        putCsvRow(Out, "feature", i, b.Position.X, b.Position.Y, b.Width, b.Height);
+        Out.Put('\n');
+    }
+    
+    for(size_t i = 0; i < MapInfo.Corridors.size(); i++)
+    {
+        for(const IPoint& p : MapInfo.Corridors[i]->Path)
+        {
+            putCsvRow(Out, "corridor", i, p.X, p.Y, 1, 1);
+            Out.Put('\n');
+        }
+    }
+    
+    for(size_t i = 0; i < MapInfo.Doors.size(); i++)
+    {
+        const Door* d = MapInfo.Doors[i];
+        putCsvRow(Out, "door", i, d->X, d->Y, 1, 1);
+        Out.Put(wallNames[d->Wall & 3]);
+        Out.Put(' ');
+        putDoorType(Out, d->Type);
+        Out.Put('\n');
+    }
+}
+
+// Tiled attribute Name="Value" with a leading space.
+static void putAttribute(BufferedSink& Out, const char* Name, int64_t Value)
+{
+    Out.Put(' ');
+    Out.Put(Name);
+    Out.Put("=\"");
+    Out.Put(Value);
+    Out.Put('"');
+}
+
+static void putTmxObject(BufferedSink& Out, int64_t& Id, const IRect& Bounds)
+{
+    Out.Put("  <object");
+    putAttribute(Out, "id", Id++);
+    putAttribute(Out, "x", (int64_t)Bounds.Position.X * TmxTileSize);
+    putAttribute(Out, "y", (int64_t)Bounds.Position.Y * TmxTileSize);
+    putAttribute(Out, "width", (int64_t)Bounds.Width * TmxTileSize);
+    putAttribute(Out, "height", (int64_t)Bounds.Height * TmxTileSize);
+}
+
+static int32 tmxTile(const TileGrid& Tiles, int32 x, int32 y)
+{
+    if(Tiles.IsDoor(x, y)) return TmxDoor;
+    if(Tiles.IsWall(x, y)) return TmxWall;
+    if(Tiles.IsRoom(x, y)) return TmxRoom;
+    if(Tiles.IsFloor(x, y)) return TmxCorridor;
+    return 0;
+}
+
+void MapExport::WriteTmx(BufferedSink& Out, const MapInfoType& MapInfo, const TileGrid* Tiles)
+{
+    int64_t objects = (int64_t)MapInfo.Rooms.size() + MapInfo.CorridorFeatures.size() + MapInfo.Corridors.size() + MapInfo.Doors.size();
+    int32 layers = (Tiles != nullptr) ? 5 : 4;
+    
+    Out.Put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    Out.Put("<map version=\"1.10\" orientation=\"orthogonal\" renderorder=\"right-down\"");
+    putAttribute(Out, "width", MapInfo.Width);
+    putAttribute(Out, "height", MapInfo.Height);
+    putAttribute(Out, "tilewidth", TmxTileSize);
+    putAttribute(Out, "tileheight", TmxTileSize);
+    Out.Put(" infinite=\"0\"");
+    putAttribute(Out, "nextlayerid", layers + 1);
+    putAttribute(Out, "nextobjectid", objects + 1);
+    Out.Put(">\n");
+    
+    Out.Put(" <tileset firstgid=\"1\" name=\"MapTiles\"");
+    putAttribute(Out, "tilewidth", TmxTileSize);
+    putAttribute(Out, "tileheight", TmxTileSize);
+    Out.Put(" tilecount=\"4\" columns=\"4\"/>\n");
+    
+    int32 layer = 1;
+    if(Tiles != nullptr)
+    {
+        Out.Put(" <layer");
+        putAttribute(Out, "id", layer++);
+        Out.Put(" name=\"Tiles\"");
+        putAttribute(Out, "width", Tiles->Width());
+        putAttribute(Out, "height", Tiles->Height());
+        putAttribute(Out, "offsetx", (int64_t)Tiles->Origin().X * TmxTileSize);
+        putAttribute(Out, "offsety", (int64_t)Tiles->Origin().Y * TmxTileSize);
+        Out.Put(">\n  <data encoding=\"csv\">\n");
+        for(int32 y = 0; y < Tiles->Height(); y++)
+        {
+            for(int32 x = 0; x < Tiles->Width(); x++)
+            {
+                Out.Put((char)('0' + tmxTile(*Tiles, x, y)));
+                // Every tile but the very last is followed by a comma.
+                if(x + 1 < Tiles->Width() || y + 1 < Tiles->Height()) Out.Put(',');
+            }
+            Out.Put('\n');
+        }
+        Out.Put("  </data>\n </layer>\n");
+    }
+    
+    int64_t id = 1;
+    Out.Put(" <objectgroup");
+    putAttribute(Out, "id", layer++);
+    Out.Put(" name=\"Rooms\">\n");
+    for(const Room* r : MapInfo.Rooms)
+    {
+        putTmxObject(Out, id, r->Bounds);
+        Out.Put(r->Enabled ? " type=\"room\"/>\n" : " type=\"room\" visible=\"0\"/>\n");
+    }
+    Out.Put(" </objectgroup>\n");
+    
+    Out.Put(" <objectgroup");
+    putAttribute(Out, "id", layer++);
+    Out.Put(" name=\"Features\">\n");
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        putTmxObject(Out, id, f->Bounds);
+        Out.Put(" type=\"feature\"/>\n");
+    }
+    Out.Put(" </objectgroup>\n");
+    
+    // Corridor paths run through tile centres, as polylines relative to their first point.
+    Out.Put(" <objectgroup");
+    putAttribute(Out, "id", layer++);
+    Out.Put(" name=\"Corridors\">\n");
+    for(const Corridor* c : MapInfo.Corridors)
+    {
+        int64_t x0 = c->Path.empty() ? c->SX : c->Path[0].X;
+        int64_t y0 = c->Path.empty() ? c->SY : c->Path[0].Y;
+        Out.Put("  <object");
+        putAttribute(Out, "id", id++);
+        putAttribute(Out, "x", x0 * TmxTileSize + TmxTileSize / 2);
+        putAttribute(Out, "y", y0 * TmxTileSize + TmxTileSize / 2);
+        Out.Put(" type=\"corridor\">\n   <polyline points=\"");
+        for(size_t p = 0; p < c->Path.size(); p++)
+        {
+            if(p > 0) Out.Put(' ');
+            Out.Put((c->Path[p].X - x0) * TmxTileSize);
+            Out.Put(',');
+            Out.Put((c->Path[p].Y - y0) * TmxTileSize);
+        }
+        Out.Put("\"/>\n  </object>\n");
+    }
+    Out.Put(" </objectgroup>\n");
+    
+    Out.Put(" <objectgroup");
+    putAttribute(Out, "id", layer++);
+    Out.Put(" name=\"Doors\">\n");
+    for(const Door* d : MapInfo.Doors)
+    {
+        putTmxObject(Out, id, IRect(d->X, d->Y, 1, 1));
+        Out.Put(" name=\"");
+        Out.Put(wallNames[d->Wall & 3]);
+        Out.Put("\" type=\"");
+        putDoorType(Out, d->Type);
+        Out.Put("\"/>\n");
+    }
+    Out.Put(" </objectgroup>\n</map>\n");
+}
+
+bool MapExport::SaveJson(const string& Path, const MapInfoType& MapInfo)
+{
+    FILE* file = fopen(Path.c_str(), "wb");
+    if(file == 0) return false;
+    
+    BufferedSink out(file);
+    WriteJson(out, MapInfo);
+    return closeSink(out, file);
+}
+
+bool MapExport::SaveCsv(const string& Path, const MapInfoType& MapInfo)
+{
+    FILE* file = fopen(Path.c_str(), "wb");
+    if(file == 0) return false;
+    
+    BufferedSink out(file);
+    WriteCsv(out, MapInfo);
+    return closeSink(out, file);
+}
+
+bool MapExport::SaveTmx(const string& Path, const MapInfoType& MapInfo, const TileGrid* Tiles)
+{
+    FILE* file = fopen(Path.c_str(), "wb");
+    if(file == 0) return false;
+    
+    BufferedSink out(file);
+    WriteTmx(out, MapInfo, Tiles);
+    return closeSink(out, file);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <string>
+#include <cstdio>
+#include <stdint.h>
+#include "MapModel.h"
+#include "TileGrid.h"
+#include "Helper.h"
+
+/**
+ * Fixed size output buffer in front of a FILE.
+ *
+ * Text and numbers are copied straight into the buffer, which is written out
+ * whenever it fills, so a writer needs no memory beyond the buffer however
+ * much it writes.
+ */
+class BufferedSink
+{
+public:
+    explicit BufferedSink(FILE* Out) : out(Out), used(0), failed(Out == 0) {}
+    ~BufferedSink() { Flush(); }
+    
+    void Put(char c)
+    {
+        if(used == sizeof(buffer)) Flush();
+        buffer[used++] = c;
+    }
+    
+    void Put(const char* Text, size_t Length);
+    void Put(const char* Text);
+    void Put(int64_t Value);
+    void Put(int32 Value) { Put((int64_t)Value); }
+    
+    /** Write out what is buffered. Returns false once any write has failed. **/
+    bool Flush();
+    bool Good() const { return !failed; }
+    
+private:
+    FILE* out;
+    size_t used;
+    bool failed;
+    char buffer[1 << 16];
+};
+
+/** Pixel size of one tile in TMX exports, Tiled gives object positions in pixels. **/
+static const int32 TmxTileSize = 16;
+
+/** Tile ids of the TMX tile layer, 0 for tiles off the map. **/
+enum TmxTile
+{
+    TmxCorridor = 1,
+    TmxRoom,
+    TmxWall,
+    TmxDoor
+};
+
+/**
+ * Text exports of a finished map, written as they are produced.
+ *
+ * Each writer walks the map once, so memory use does not grow with the map.
+ * The exports hold the geometry of the map, rooms, corridor features, corridor
+ * paths and doors. Links between them are kept only by the binary MapFile.
+ */
+class MapExport
+{
+public:
+    /** JSON object with seed, width, height and arrays of rooms, features, corridors and doors. **/
+    static void WriteJson(BufferedSink& Out, const MapInfoType& MapInfo);
+    
+    /**
+     * CSV table with the columns kind, id, x, y, width, height and info. Corridors get
+     * one row per path point, info holds a room's enabled flag or a door's wall and type.
+     */
+    static void WriteCsv(BufferedSink& Out, const MapInfoType& MapInfo);
+    
+    /**
+     * Tiled TMX map with an object layer each for rooms, features, corridors and doors.
+     * When Tiles is given it is also written as a tile layer of TmxTile ids.
+     */
+    static void WriteTmx(BufferedSink& Out, const MapInfoType& MapInfo, const TileGrid* Tiles = nullptr);
+    
+    /** Write an export to Path. Returns false if the file could not be written. **/
+    static bool SaveJson(const std::string& Path, const MapInfoType& MapInfo);
+    static bool SaveCsv(const std::string& Path, const MapInfoType& MapInfo);
+    static bool SaveTmx(const std::string& Path, const MapInfoType& MapInfo, const TileGrid* Tiles = nullptr);
+};
\ No newline at end of file
@@ -0,0 +1,367 @@
+#include "MapFile.h"
+#include "MapBuilderLib.h"
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#ifdef _WIN32
+#include <cstdlib>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// The layout is the file format, a change here needs a new MapFileVersion.
+static_assert(sizeof(MapFileHeader) == 200, "MapFileHeader layout changed");
+static_assert(sizeof(MapFileRoom) == 24 && sizeof(MapFileCorridor) == 40 && sizeof(MapFileFeature) == 24, "MapFile record layout changed");
+static_assert(sizeof(MapFileDoor) == 32 && sizeof(MapFileEdge) == 8 && sizeof(MapFileTiles) == 32 && sizeof(MapFileLink) == 8, "MapFile record layout changed");
+
+// The records are written straight from memory, which only gives the file layout on little endian hosts.
+static bool isLittleEndian()
+{
+    uint16_t one = 1;
+    return *(const uint8_t*)&one == 1;
+}
+
+static uint64_t alignUp(uint64_t v)
+{
+    return (v + MapFileAlignment - 1) & ~(uint64_t)(MapFileAlignment - 1);
+}
+
+static MapFileRect toRect(const IRect& r)
+{
+    MapFileRect rect = { r.Position.X, r.Position.Y, r.Width, r.Height };
+    return rect;
+}
+
+// Append Count records to the file image at the next aligned offset.
+static MapFileSection appendSection(vector<uint8_t>& file, const void* Records, size_t RecordSize, uint64_t Count)
+{
+    MapFileSection section = { alignUp(file.size()), Count };
+    file.resize(section.Offset + RecordSize * Count, 0);
+    if(Count > 0)
+    {
+        memcpy(&file[section.Offset], Records, RecordSize * Count);
+    }
+    return section;
+}
+
+template<typename T>
+static MapFileSection appendSection(vector<uint8_t>& file, const vector<T>& Records)
+{
+    return appendSection(file, Records.empty() ? 0 : &Records[0], sizeof(T), Records.size());
+}
+
+// Add Owner's list to links, entries indexOf could not find left out.
+template<typename T, typename Fn>
+static void appendLinks(vector<MapFileLink>& links, int32 Owner, const vector<T*>& List, Fn indexOf)
+{
+    for(const T* target : List)
+    {
+        MapFileLink link = { Owner, indexOf(target) };
+        if(link.Target >= 0) links.push_back(link);
+    }
+}
+
+// Call fn(owner, target) for each link whose indices are in range.
+template<typename Fn>
+static void readLinks(const MapFileLink* Links, int32 Count, int32 Owners, int32 Targets, Fn fn)
+{
+    for(int32 i = 0; i < Count; i++)
+    {
+        const MapFileLink& link = Links[i];
+        if(link.Owner >= 0 && link.Owner < Owners && link.Target >= 0 && link.Target < Targets)
+        {
+            fn(link.Owner, link.Target);
+        }
+    }
+}
+
+bool MapFile::Save(const string& Path, const MapInfoType& MapInfo, const list<int32>* Edges, const TileGrid* Tiles)
+{
+    if(!isLittleEndian()) return false;
+    
+    // Pointers become indices.
+    unordered_map<const void*, int32> index;
+    for(int32 i = 0; i < (int32)MapInfo.Rooms.size(); i++) index[MapInfo.Rooms[i]] = i;
+    for(int32 i = 0; i < (int32)MapInfo.Corridors.size(); i++) index[MapInfo.Corridors[i]] = i;
+    for(int32 i = 0; i < (int32)MapInfo.CorridorFeatures.size(); i++) index[MapInfo.CorridorFeatures[i]] = i;
+    auto indexOf = [&](const void* p) -> int32
+    {
+        auto found = index.find(p);
+        return (p == 0 || found == index.end()) ? -1 : found->second;
+    };
+    
+    vector<MapFileRoom> rooms;
+    for(const Room* r : MapInfo.Rooms)
+    {
+        MapFileRoom room = { toRect(r->Bounds), r->Enabled ? 1 : 0, 0 };
+        rooms.push_back(room);
+    }
+    
+    vector<MapFileCorridor> corridors;
+    vector<MapFilePoint> points;
+    for(const Corridor* c : MapInfo.Corridors)
+    {
+        MapFileCorridor corridor = { c->SX, c->SY, c->EX, c->EY, toRect(c->Bounds), (uint32_t)points.size(), (uint32_t)c->Path.size() };
+        corridors.push_back(corridor);
+        for(const IPoint& p : c->Path)
+        {
+            MapFilePoint point = { p.X, p.Y };
+            points.push_back(point);
+        }
+    }
+    
+    vector<MapFileFeature> features;
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        MapFileFeature feature = { toRect(f->Bounds), indexOf(f->LinkedCorridor), 0 };
+        features.push_back(feature);
+    }
+    
+    vector<MapFileDoor> doors;
+    for(const Door* d : MapInfo.Doors)
+    {
+        uint32_t flags = (d->Type.IsOpen ? DoorOpen : 0) | (d->Type.IsLocked ? DoorLocked : 0) |
+                         (d->Type.IsDestructable ? DoorDestructable : 0) | (d->Type.IsHidden ? DoorHidden : 0);
+        MapFileDoor door = { d->X, d->Y, d->Wall, flags, indexOf(d->LinkedCorridor), indexOf(d->LinkedRoom), indexOf(d->LinkedFeature), 0 };
+        doors.push_back(door);
+    }
+    
+    // The lists the pipeline built are kept as they are, they can't be worked out again from the doors.
+    vector<MapFileLink> roomCorridors, featureCorridors, corridorFeatures;
+    for(int32 i = 0; i < (int32)MapInfo.Rooms.size(); i++)
+    {
+        appendLinks(roomCorridors, i, MapInfo.Rooms[i]->Corridors, indexOf);
+    }
+    for(int32 i = 0; i < (int32)MapInfo.CorridorFeatures.size(); i++)
+    {
+        appendLinks(featureCorridors, i, MapInfo.CorridorFeatures[i]->Corridors, indexOf);
+    }
+    for(int32 i = 0; i < (int32)MapInfo.Corridors.size(); i++)
+    {
+        appendLinks(corridorFeatures, i, MapInfo.Corridors[i]->Features, indexOf);
+    }
+    
+    vector<MapFileEdge> edges;
+    if(Edges != nullptr)
+    {
+        for(list<int32>::const_iterator itr = Edges->begin(); itr != Edges->end(); itr++)
+        {
+            MapFileEdge edge;
+            edge.A = *(itr++);
+            if(itr == Edges->end()) break;
+            edge.B = *itr;
+            edges.push_back(edge);
+        }
+    }
+    
+    vector<uint8_t> file(sizeof(MapFileHeader), 0);
+    MapFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, MapFileMagic, sizeof(header.Magic));
+    header.Version = MapFileVersion;
+    header.HeaderSize = sizeof(MapFileHeader);
+    header.Seed = MapInfo.Seed;
+    header.Width = MapInfo.Width;
+    header.Height = MapInfo.Height;
+    header.Rooms = appendSection(file, rooms);
+    header.Corridors = appendSection(file, corridors);
+    header.Points = appendSection(file, points);
+    header.Features = appendSection(file, features);
+    header.Doors = appendSection(file, doors);
+    header.Edges = appendSection(file, edges);
+    header.RoomCorridors = appendSection(file, roomCorridors);
+    header.FeatureCorridors = appendSection(file, featureCorridors);
+    header.CorridorFeatures = appendSection(file, corridorFeatures);
+    
+    if(Tiles != nullptr)
+    {
+        const BitGrid& floor = Tiles->Plane(FloorPlane);
+        MapFileTiles tiles = { Tiles->Origin().X, Tiles->Origin().Y, floor.Width(), floor.Height(), floor.Stride(), TilePlaneCount, 0 };
+        header.Tiles = appendSection(file, &tiles, sizeof(tiles), 1);
+        
+        size_t planeBytes = (size_t)floor.Stride() * floor.Height() * sizeof(uint64_t);
+        size_t offset = file.size();
+        file.resize(offset + planeBytes * TilePlaneCount);
+        for(int32 p = 0; p < TilePlaneCount && planeBytes > 0; p++)
+        {
+            memcpy(&file[offset + p * planeBytes], Tiles->Plane(p).Row(0), planeBytes);
+        }
+    }
+    
+    header.FileSize = file.size();
+    memcpy(&file[0], &header, sizeof(header));
+    
+    FILE* out = fopen(Path.c_str(), "wb");
+    if(out == 0) return false;
+    bool written = (fwrite(&file[0], 1, file.size(), out) == file.size());
+    return (fclose(out) == 0) && written;
+}
+
+bool MappedMap::Open(const string& Path)
+{
+    Close();
+    if(!isLittleEndian()) return false;
+    
+#ifdef _WIN32
+    FILE* in = fopen(Path.c_str(), "rb");
+    if(in == 0) return false;
+    fseek(in, 0, SEEK_END);
+    size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    uint8_t* buffer = (uint8_t*)malloc(size > 0 ? size : 1);
+    bool read = (fread(buffer, 1, size, in) == size);
+    fclose(in);
+    data = buffer;
+    mapped = false;
+    if(!read)
+    {
+        Close();
+        return false;
+    }
+#else
+    int fd = open(Path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(MapFileHeader))
+    {
+        close(fd);
+        return false;
+    }
+    size = info.st_size;
+    void* view = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(view == MAP_FAILED) return false;
+    data = (const uint8_t*)view;
+    mapped = true;
+#endif
+    
+    if(!Validate())
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedMap::Close()
+{
+    if(data == 0) return;
+    
+#ifdef _WIN32
+    free((void*)data);
+#else
+    if(mapped)
+    {
+        munmap((void*)data, size);
+    }
+#endif
+    data = 0;
+    size = 0;
+}
+
+bool MappedMap::Validate() const
+{
+    if(size < sizeof(MapFileHeader)) return false;
+    
+    const MapFileHeader& header = Header();
+    if(memcmp(header.Magic, MapFileMagic, sizeof(header.Magic)) != 0) return false;
+    if(header.Version != MapFileVersion || header.HeaderSize != sizeof(MapFileHeader) || header.FileSize != size) return false;
+    
+    // Each section must be aligned and lie inside the file.
+    const MapFileSection* sections[] = { &header.Rooms, &header.Corridors, &header.Points, &header.Features, &header.Doors, &header.Edges, &header.Tiles,
+                                         &header.RoomCorridors, &header.FeatureCorridors, &header.CorridorFeatures };
+    const uint64_t recordSizes[] = { sizeof(MapFileRoom), sizeof(MapFileCorridor), sizeof(MapFilePoint), sizeof(MapFileFeature),
+                                     sizeof(MapFileDoor), sizeof(MapFileEdge), sizeof(MapFileTiles), sizeof(MapFileLink), sizeof(MapFileLink), sizeof(MapFileLink) };
+    for(int32 i = 0; i < 10; i++)
+    {
+        const MapFileSection& s = *sections[i];
+        if(s.Offset % MapFileAlignment != 0 || s.Offset > size) return false;
+        if(s.Count > (size - s.Offset) / recordSizes[i]) return false;
+    }
+    if(header.Tiles.Count > 1) return false;
+    
+    if(HasTiles())
+    {
+        const MapFileTiles& tiles = Tiles();
+        if(tiles.Width < 0 || tiles.Height < 0 || tiles.Stride != ((int64_t)tiles.Width + 63) / 64 || tiles.Planes != TilePlaneCount) return false;
+        
+        uint64_t words = (uint64_t)tiles.Stride * tiles.Height * tiles.Planes;
+        if(words > (size - header.Tiles.Offset - sizeof(MapFileTiles)) / sizeof(uint64_t)) return false;
+    }
+    return true;
+}
+
+void MappedMap::ToMapInfo(MapInfoType& MapInfo) const
+{
+    const MapFileHeader& header = Header();
+    UMapBuilderLib::InitMap(MapInfo, header.Width, header.Height);
+    MapInfo.Seed = header.Seed;
+    
+    for(int32 i = 0; i < RoomCount(); i++)
+    {
+        const MapFileRect& b = Rooms()[i].Bounds;
+        Room* room = new Room(b.X, b.Y, b.Width, b.Height);
+        room->Enabled = (Rooms()[i].Enabled != 0);
+        MapInfo.Rooms.push_back(room);
+    }
+    
+    int32 points = header.Points.Count;
+    for(int32 i = 0; i < CorridorCount(); i++)
+    {
+        const MapFileCorridor& c = Corridors()[i];
+        Corridor* corridor = new Corridor();
+        corridor->SX = c.SX;
+        corridor->SY = c.SY;
+        corridor->EX = c.EX;
+        corridor->EY = c.EY;
+        corridor->Bounds = IRect(c.Bounds.X, c.Bounds.Y, c.Bounds.Width, c.Bounds.Height);
+        for(uint32_t k = c.FirstPoint; k < c.FirstPoint + c.PointCount && (int32)k < points; k++)
+        {
+            corridor->Path.push_back(IPoint(Points()[k].X, Points()[k].Y));
+        }
+        MapInfo.Corridors.push_back(corridor);
+    }
+    
+    int32 corridors = MapInfo.Corridors.size();
+    for(int32 i = 0; i < FeatureCount(); i++)
+    {
+        const MapFileFeature& f = Features()[i];
+        CorridorFeature* feature = new CorridorFeature(f.Bounds.X, f.Bounds.Y, f.Bounds.Width, f.Bounds.Height);
+        if(f.LinkedCorridor >= 0 && f.LinkedCorridor < corridors)
+        {
+            feature->LinkedCorridor = MapInfo.Corridors[f.LinkedCorridor];
+        }
+        MapInfo.CorridorFeatures.push_back(feature);
+    }
+    
+    int32 rooms = MapInfo.Rooms.size();
+    int32 features = MapInfo.CorridorFeatures.size();
+    for(int32 i = 0; i < DoorCount(); i++)
+    {
+        const MapFileDoor& d = Doors()[i];
+        DoorType type = { (d.Flags & DoorOpen) != 0, (d.Flags & DoorLocked) != 0, (d.Flags & DoorDestructable) != 0, (d.Flags & DoorHidden) != 0 };
+        Door* door = new Door(d.X, d.Y, d.Wall, type);
+        if(d.LinkedCorridor >= 0 && d.LinkedCorridor < corridors) door->LinkedCorridor = MapInfo.Corridors[d.LinkedCorridor];
+        if(d.LinkedRoom >= 0 && d.LinkedRoom < rooms) door->LinkedRoom = MapInfo.Rooms[d.LinkedRoom];
+        if(d.LinkedFeature >= 0 && d.LinkedFeature < features) door->LinkedFeature = MapInfo.CorridorFeatures[d.LinkedFeature];
+        MapInfo.Doors.push_back(door);
+    }
+    
+    readLinks(RoomCorridors(), RoomCorridorCount(), rooms, corridors, [&](int32 owner, int32 target)
+    {
+        MapInfo.Rooms[owner]->Corridors.push_back(MapInfo.Corridors[target]);
+    });
+    readLinks(FeatureCorridors(), FeatureCorridorCount(), features, corridors, [&](int32 owner, int32 target)
+    {
+        MapInfo.CorridorFeatures[owner]->Corridors.push_back(MapInfo.Corridors[target]);
+    });
+    readLinks(CorridorFeatures(), CorridorFeatureCount(), corridors, features, [&](int32 owner, int32 target)
+    {
+        MapInfo.Corridors[owner]->Features.push_back(MapInfo.CorridorFeatures[target]);
+    });
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <stdint.h>
+#include "MapModel.h"
+#include "TileGrid.h"
+#include "Helper.h"
+
+/**
+ * Binary layout of a finished map, written by MapFile::Save and read in place
+ * by MappedMap.
+ *
+ * The file is a MapFileHeader followed by one section per array. Every field
+ * is a fixed width little endian integer, every section starts on a 64 byte
+ * boundary, and records refer to each other by index, -1 for none, so a
+ * mapped file can be read without any decoding. Readers reject a file whose
+ * Version they do not know.
+ */
+static const char MapFileMagic[8] = { 'M', 'A', 'P', 'G', 'E', 'N', 0, 0 };
+static const uint32_t MapFileVersion = 2;
+static const uint32_t MapFileAlignment = 64;
+
+typedef struct
+{
+    uint64_t Offset;    // Bytes from the start of the file.
+    uint64_t Count;     // Records in the section.
+} MapFileSection;
+
+typedef struct
+{
+    int32_t X, Y, Width, Height;
+} MapFileRect;
+
+typedef struct
+{
+    int32_t X, Y;
+} MapFilePoint;
+
+typedef struct
+{
+    MapFileRect Bounds;
+    int32_t Enabled;
+    int32_t Reserved;
+} MapFileRoom;
+
+typedef struct
+{
+    int32_t SX, SY, EX, EY;
+    MapFileRect Bounds;
+    uint32_t FirstPoint;    // Path is Points[FirstPoint .. FirstPoint + PointCount).
+    uint32_t PointCount;
+} MapFileCorridor;
+
+typedef struct
+{
+    MapFileRect Bounds;
+    int32_t LinkedCorridor;
+    int32_t Reserved;
+} MapFileFeature;
+
+/** Bits of MapFileDoor::Flags, one per DoorType field. **/
+enum MapFileDoorFlags
+{
+    DoorOpen = 1,
+    DoorLocked = 2,
+    DoorDestructable = 4,
+    DoorHidden = 8
+};
+
+typedef struct
+{
+    int32_t X, Y, Wall;
+    uint32_t Flags;
+    int32_t LinkedCorridor, LinkedRoom, LinkedFeature;
+    int32_t Reserved;
+} MapFileDoor;
+
+typedef struct
+{
+    int32_t A, B;   // Rooms joined by a corridor, in the order the corridors were generated.
+} MapFileEdge;
+
+/** One entry of a room's, feature's or corridor's list of links, lists in order and each in its own order. **/
+typedef struct
+{
+    int32_t Owner;  // Room, feature or corridor holding the list.
+    int32_t Target; // Corridor or feature in it.
+} MapFileLink;
+
+/** Header of the tile section, followed by Planes planes of Height rows of Stride words. **/
+typedef struct
+{
+    int32_t OriginX, OriginY;
+    int32_t Width, Height;
+    int32_t Stride;
+    int32_t Planes;
+    uint64_t Reserved;
+} MapFileTiles;
+
+typedef struct
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t HeaderSize;
+    uint64_t FileSize;
+    int32_t Seed, Width, Height;
+    int32_t Reserved;
+    MapFileSection Rooms;
+    MapFileSection Corridors;
+    MapFileSection Points;
+    MapFileSection Features;
+    MapFileSection Doors;
+    MapFileSection Edges;
+    MapFileSection Tiles;   // Count is 1 when a tile grid was saved, otherwise 0.
+    MapFileSection RoomCorridors;       // Room::Corridors.
+    MapFileSection FeatureCorridors;    // CorridorFeature::Corridors.
+    MapFileSection CorridorFeatures;    // Corridor::Features.
+} MapFileHeader;
+
+class MapFile
+{
+public:
+    /**
+     * Write MapInfo to Path. Edges is the room index pair list given to GenerateCorridors,
+     * Tiles an optional rasterised grid. Returns false if the file could not be written.
+     */
+    static bool Save(const std::string& Path, const MapInfoType& MapInfo, const std::list<int32>* Edges = nullptr, const TileGrid* Tiles = nullptr);
+};
+
+/**
+ * A map file mapped into memory and read in place.
+ *
+ * Open maps the file and checks the header and that each section lies inside
+ * it, which does not depend on the size of the map. The accessors then point
+ * straight into the mapping and stay valid until Close.
+ */
+class MappedMap
+{
+public:
+    MappedMap() : data(0), size(0), mapped(false) {}
+    ~MappedMap() { Close(); }
+    
+    bool Open(const std::string& Path);
+    void Close();
+    bool IsOpen() const { return data != 0; }
+    
+    const MapFileHeader& Header() const { return *(const MapFileHeader*)data; }
+    
+    int32 RoomCount() const { return Header().Rooms.Count; }
+    int32 CorridorCount() const { return Header().Corridors.Count; }
+    int32 FeatureCount() const { return Header().Features.Count; }
+    int32 DoorCount() const { return Header().Doors.Count; }
+    int32 EdgeCount() const { return Header().Edges.Count; }
+    int32 RoomCorridorCount() const { return Header().RoomCorridors.Count; }
+    int32 FeatureCorridorCount() const { return Header().FeatureCorridors.Count; }
+    int32 CorridorFeatureCount() const { return Header().CorridorFeatures.Count; }
+    
+    const MapFileRoom* Rooms() const { return Section<MapFileRoom>(Header().Rooms); }
+    const MapFileCorridor* Corridors() const { return Section<MapFileCorridor>(Header().Corridors); }
+    const MapFilePoint* Points() const { return Section<MapFilePoint>(Header().Points); }
+    const MapFileFeature* Features() const { return Section<MapFileFeature>(Header().Features); }
+    const MapFileDoor* Doors() const { return Section<MapFileDoor>(Header().Doors); }
+    const MapFileEdge* Edges() const { return Section<MapFileEdge>(Header().Edges); }
+    const MapFileLink* RoomCorridors() const { return Section<MapFileLink>(Header().RoomCorridors); }
+    const MapFileLink* FeatureCorridors() const { return Section<MapFileLink>(Header().FeatureCorridors); }
+    const MapFileLink* CorridorFeatures() const { return Section<MapFileLink>(Header().CorridorFeatures); }
+    
+    bool HasTiles() const { return Header().Tiles.Count != 0; }
+    const MapFileTiles& Tiles() const { return *Section<MapFileTiles>(Header().Tiles); }
+    
+    /** Row y of a TilePlane, laid out as BitGrid::Row. **/
+    const uint64_t* TileRow(int32 Plane, int32 y) const
+    {
+        const MapFileTiles& tiles = Tiles();
+        return (const uint64_t*)(&tiles + 1) + ((size_t)Plane * tiles.Height + y) * tiles.Stride;
+    }
+    
+    /** Rebuild the pointer based model, for code that needs to change the map. **/
+    void ToMapInfo(MapInfoType& MapInfo) const;
+    
+private:
+    const uint8_t* data;
+    size_t size;
+    bool mapped;    // False when the file was read into memory instead.
+    
+    template<typename T>
+    const T* Section(const MapFileSection& s) const { return (const T*)(data + s.Offset); }
+    
+    bool Validate() const;
+};
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "MapRaster.h"
+#include "Parallel.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+static uint32_t pack(const MapColour& Colour)
+{
+    uint32_t v;
+    memcpy(&v, &Colour, sizeof(v));
+    return v;
+}
+
+void MapImage::Resize(int32 Width, int32 Height)
+{
+    width = max(Width, 0);
+    height = max(Height, 0);
+    pixels.assign((size_t)width * height, pack(BackgroundColour));
+}
+
+void MapImage::Clear(const MapColour& Colour)
+{
+    fill(pixels.begin(), pixels.end(), pack(Colour));
+}
+
+MapColour MapImage::Pixel(int32 x, int32 y) const
+{
+    MapColour c;
+    memcpy(&c, &pixels[(size_t)y * width + x], sizeof(c));
+    return c;
+}
+
+void MapImage::FillRect(int32 x0, int32 y0, int32 x1, int32 y1, const MapColour& Colour)
+{
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, width);
+    y1 = min(y1, height);
+    if(x0 >= x1 || y0 >= y1) return;
+    
+    uint32_t v = pack(Colour);
+    for(int32 y = y0; y < y1; y++)
+    {
+        uint32_t* row = &pixels[(size_t)y * width];
+        fill(row + x0, row + x1, v);
+    }
+}
+
+void MapImage::Line(float x0, float y0, float x1, float y1, const MapColour& Colour)
+{
+    // Liang-Barsky clip to the pixel centres, so the stepping below never leaves the image.
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float t0 = 0.f, t1 = 1.f;
+    const float p[4] = { -dx, dx, -dy, dy };
+    const float q[4] = { x0, (width - 1) - x0, y0, (height - 1) - y0 };
+    for(int32 i = 0; i < 4; i++)
+    {
+        if(p[i] == 0.f)
+        {
+            if(q[i] < 0.f) return;
+            continue;
+        }
+        float t = q[i] / p[i];
+        if(p[i] < 0.f)
+        {
+            if(t > t1) return;
+            t0 = max(t0, t);
+        }
+        else
+        {
+            if(t < t0) return;
+            t1 = min(t1, t);
+        }
+    }
+    
+    // Bresenham between the clipped ends.
+    int32 ax = min(max((int32)lroundf(x0 + t0 * dx), 0), width - 1);
+    int32 ay = min(max((int32)lroundf(y0 + t0 * dy), 0), height - 1);
+    int32 bx = min(max((int32)lroundf(x0 + t1 * dx), 0), width - 1);
+    int32 by = min(max((int32)lroundf(y0 + t1 * dy), 0), height - 1);
+    
+    uint32_t v = pack(Colour);
+    int32 stepX = (ax < bx) ? 1 : -1;
+    int32 stepY = (ay < by) ? 1 : -1;
+    int32 ex = abs(bx - ax);
+    int32 ey = -abs(by - ay);
+    int32 err = ex + ey;
+    while(true)
+    {
+        pixels[(size_t)ay * width + ax] = v;
+        if(ax == bx && ay == by) break;
+        
+        int32 e2 = 2 * err;
+        if(e2 >= ey)
+        {
+            err += ey;
+            ax += stepX;
+        }
+        if(e2 <= ex)
+        {
+            err += ex;
+            ay += stepY;
+        }
+    }
+}
+
+bool MapImage::SavePpm(const string& Path) const
+{
+    FILE* out = fopen(Path.c_str(), "wb");
+    if(out == 0) return false;
+    
+    fprintf(out, "P6\n%d %d\n255\n", width, height);
+    vector<uint8_t> rgb((size_t)width * 3);
+    bool written = true;
+    for(int32 y = 0; y < height && written; y++)
+    {
+        const uint8_t* src = (const uint8_t*)Row(y);
+        for(int32 x = 0; x < width; x++)
+        {
+            rgb[x * 3] = src[x * 4];
+            rgb[x * 3 + 1] = src[x * 4 + 1];
+            rgb[x * 3 + 2] = src[x * 4 + 2];
+        }
+        written = (fwrite(rgb.data(), 1, rgb.size(), out) == rgb.size());
+    }
+    return (fclose(out) == 0) && written;
+}
+
+static uint32_t crc32(uint32_t Crc, const uint8_t* Data, size_t Size)
+{
+    // Built once, the first time any thread needs it.
+    static const vector<uint32_t> table = []()
+    {
+        vector<uint32_t> t(256);
+        for(uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for(int32 k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    
+    Crc = ~Crc;
+    for(size_t i = 0; i < Size; i++)
+    {
+        Crc = table[(Crc ^ Data[i]) & 0xFF] ^ (Crc >> 8);
+    }
+    return ~Crc;
+}
+
+static void putBigEndian(vector<uint8_t>& Out, uint32_t v)
+{
+    Out.push_back((uint8_t)(v >> 24));
+    Out.push_back((uint8_t)(v >> 16));
+    Out.push_back((uint8_t)(v >> 8));
+    Out.push_back((uint8_t)v);
+}
+
+// Append a PNG chunk, length, type, data and the CRC of type and data.
+static void putChunk(vector<uint8_t>& Out, const char* Type, const uint8_t* Data, size_t Size)
+{
+    putBigEndian(Out, Size);
+    size_t start = Out.size();
+    Out.insert(Out.end(), Type, Type + 4);
+    Out.insert(Out.end(), Data, Data + Size);
+    putBigEndian(Out, crc32(0, &Out[start], Out.size() - start));
+}
+
+bool MapImage::SavePng(const string& Path) const
+{
+    // Each row is a filter byte, 0 for none, then the RGBA pixels.
+    size_t rowBytes = (size_t)width * 4 + 1;
+    size_t rawBytes = rowBytes * height;
+    vector<uint8_t> raw(rawBytes);
+    for(int32 y = 0; y < height; y++)
+    {
+        raw[y * rowBytes] = 0;
+        memcpy(&raw[y * rowBytes + 1], Row(y), width * 4);
+    }
+    
+    // A zlib stream of stored deflate blocks, at most 65535 bytes each.
+    vector<uint8_t> z;
+    z.reserve(rawBytes + rawBytes / 65535 * 5 + 16);
+    z.push_back(0x78);
+    z.push_back(0x01);
+    size_t done = 0;
+    do
+    {
+        uint32_t n = (uint32_t)min(rawBytes - done, (size_t)65535);
+        z.push_back((done + n == rawBytes) ? 1 : 0);
+        z.push_back((uint8_t)n);
+        z.push_back((uint8_t)(n >> 8));
+        z.push_back((uint8_t)~n);
+        z.push_back((uint8_t)(~n >> 8));
+        z.insert(z.end(), raw.begin() + done, raw.begin() + done + n);
+        done += n;
+    } while(done < rawBytes);
+    
+    uint32_t a = 1, b = 0;
+    for(size_t i = 0; i < rawBytes; i++)
+    {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBigEndian(z, (b << 16) | a);
+    
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    vector<uint8_t> file(signature, signature + 8);
+    vector<uint8_t> header;
+    putBigEndian(header, width);
+    putBigEndian(header, height);
+    const uint8_t format[5] = { 8, 6, 0, 0, 0 };   // 8 bit RGBA, no interlace.
+    header.insert(header.end(), format, format + 5);
+    putChunk(file, "IHDR", header.data(), header.size());
+    putChunk(file, "IDAT", z.data(), z.size());
+    putChunk(file, "IEND", 0, 0);
+    
+    FILE* out = fopen(Path.c_str(), "wb");
+    if(out == 0) return false;
+    bool written = (fwrite(file.data(), 1, file.size(), out) == file.size());
+    return (fclose(out) == 0) && written;
+}
+
+// Filled box with a one pixel outline, drawn as main.cpp draws rooms.
+static void drawBox(MapImage& Image, const IRect& Bounds, float Scale, const MapColour& Fill, const MapColour& Line)
+{
+    float x0 = Bounds.Position.X * Scale;
+    float y0 = Bounds.Position.Y * Scale;
+    float x1 = (Bounds.Position.X + Bounds.Width) * Scale;
+    float y1 = (Bounds.Position.Y + Bounds.Height) * Scale;
+    
+    Image.FillRect((int32)floorf(x0), (int32)floorf(y0), max((int32)floorf(x1), (int32)floorf(x0) + 1), max((int32)floorf(y1), (int32)floorf(y0) + 1), Fill);
+    Image.Line(x0, y0, x1, y0, Line);
+    Image.Line(x0, y0, x0, y1, Line);
+    Image.Line(x1, y1, x0, y1, Line);
+    Image.Line(x1, y1, x1, y0, Line);
+}
+
+void MapRenderer::Draw(const MapInfoType& MapInfo, MapImage& Image, float Scale, const MapOverlay* Overlay)
+{
+    for(const Room* r : MapInfo.Rooms)
+    {
+        drawBox(Image, r->Bounds, Scale, RoomFillColour, RoomLineColour);
+    }
+    
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        drawBox(Image, f->Bounds, Scale, CorridorFillColour, CorridorLineColour);
+    }
+    
+    if(Overlay != nullptr && Overlay->Tri != nullptr)
+    {
+        const Triangulation& tri = *Overlay->Tri;
+        for(int32 i = 0; i < tri.nEdges; i++)
+        {
+            const FPoint* a = tri.point[tri.edge[i]->s];
+            const FPoint* b = tri.point[tri.edge[i]->t];
+            Image.Line(a->X * Scale, a->Y * Scale, b->X * Scale, b->Y * Scale, DelaunayLineColour);
+        }
+        
+        if(Overlay->MinSpan != nullptr)
+        {
+            for(auto itr = Overlay->MinSpan->begin(); itr != Overlay->MinSpan->end(); itr++)
+            {
+                const FPoint* a = tri.point[*itr++];
+                if(itr == Overlay->MinSpan->end()) break;
+                const FPoint* b = tri.point[*itr];
+                Image.Line(a->X * Scale, a->Y * Scale, b->X * Scale, b->Y * Scale, FinalEdgeLineColour);
+            }
+        }
+    }
+    
+    for(const Corridor* c : MapInfo.Corridors)
+    {
+        for(size_t i = 1; i < c->Path.size(); i++)
+        {
+            Image.Line(c->Path[i - 1].X * Scale, c->Path[i - 1].Y * Scale, c->Path[i].X * Scale, c->Path[i].Y * Scale, CorridorLineColour);
+        }
+    }
+    
+    int32 doorSize = max((int32)Scale, 1);
+    for(const Door* d : MapInfo.Doors)
+    {
+        int32 x = (int32)floorf(d->X * Scale);
+        int32 y = (int32)floorf(d->Y * Scale);
+        Image.FillRect(x, y, x + doorSize, y + doorSize, DoorColour);
+    }
+}
+
+void MapRenderer::Thumbnail(const MapInfoType& MapInfo, MapImage& Image, int32 Size, const MapOverlay* Overlay)
+{
+    if(Image.Width() != Size || Image.Height() != Size)
+    {
+        Image.Resize(Size, Size);
+    }
+    Image.Clear(BackgroundColour);
+    
+    // The outlines at the far edge of the map land on the last pixel.
+    int32 extent = max(max(MapInfo.Width, MapInfo.Height), 1);
+    Draw(MapInfo, Image, (float)(Size - 1) / extent, Overlay);
+}
+
+void MapRenderer::Thumbnails(const vector<const MapInfoType*>& Maps, vector<MapImage>& Images, int32 Size,
+                             const vector<const MapOverlay*>& Overlays, int32 Threads)
+{
+    Images.resize(Maps.size());
+    Parallel::For(0, Maps.size(), [&](int32 Begin, int32 End, int32)
+    {
+        for(int32 i = Begin; i < End; i++)
+        {
+            Thumbnail(*Maps[i], Images[i], Size, Overlays.empty() ? nullptr : Overlays[i]);
+        }
+    }, Threads);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <stdint.h>
+#include "MapModel.h"
+#include "MapColours.h"
+#include "Delaunay.h"
+#include "Helper.h"
+
+/** An RGBA image in memory, rows top to bottom, one uint32_t per pixel in MapColour byte order. **/
+class MapImage
+{
+public:
+    MapImage() : width(0), height(0) {}
+    MapImage(int32 Width, int32 Height) { Resize(Width, Height); }
+    
+    void Resize(int32 Width, int32 Height);
+    void Clear(const MapColour& Colour);
+    
+    int32 Width() const { return width; }
+    int32 Height() const { return height; }
+    const uint32_t* Row(int32 y) const { return &pixels[(size_t)y * width]; }
+    MapColour Pixel(int32 x, int32 y) const;
+    
+    /** Fill the pixels x0 to x1 - 1, y0 to y1 - 1, clipped to the image. **/
+    void FillRect(int32 x0, int32 y0, int32 x1, int32 y1, const MapColour& Colour);
+    
+    /** One pixel wide line from (x0, y0) to (x1, y1), both ends included, clipped to the image. **/
+    void Line(float x0, float y0, float x1, float y1, const MapColour& Colour);
+    
+    /** Binary PPM, alpha dropped. Returns false if the file could not be written. **/
+    bool SavePpm(const std::string& Path) const;
+    
+    /** PNG using uncompressed deflate blocks, quick to write and readable everywhere. **/
+    bool SavePng(const std::string& Path) const;
+    
+private:
+    int32 width;
+    int32 height;
+    std::vector<uint32_t> pixels;
+};
+
+/** Optional stages of the pipeline to draw over the map. **/
+typedef struct
+{
+    const Triangulation* Tri;           /** Delaunay edges between room centres. **/
+    const std::list<int32>* MinSpan;    /** Index pairs into Tri's points, as returned by CalcMinSpan. **/
+} MapOverlay;
+
+/**
+ * Draws a map into a MapImage without a window, in the colours of main.cpp:
+ * rooms, corridor features, the Delaunay and spanning tree edges when given,
+ * then corridors and doors.
+ *
+ * Drawing only reads the map and writes the image, so any number of threads
+ * may render different maps at once.
+ */
+class MapRenderer
+{
+public:
+    /** Draw MapInfo with map tile (x, y) at pixel (x * Scale, y * Scale). The image is not cleared first. **/
+    static void Draw(const MapInfoType& MapInfo, MapImage& Image, float Scale, const MapOverlay* Overlay = nullptr);
+    
+    /** Clear Image to Size x Size and draw the whole map scaled to fit it. **/
+    static void Thumbnail(const MapInfoType& MapInfo, MapImage& Image, int32 Size, const MapOverlay* Overlay = nullptr);
+    
+    /**
+     * Thumbnail every map, spread over Threads threads, 0 for one per core. Images is resized to match.
+     * Overlays is either empty or holds one overlay, or nullptr, per map.
+     */
+    static void Thumbnails(const std::vector<const MapInfoType*>& Maps, std::vector<MapImage>& Images, int32 Size,
+                           const std::vector<const MapOverlay*>& Overlays = std::vector<const MapOverlay*>(), int32 Threads = 0);
+};
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "MapValidator.h"
+#include "MapBuilderLib.h"
+#include "CorridorEndpoints.h"
+#include <algorithm>
+#include <cstdlib>
+#include <climits>
+
+using namespace std;
+
+// Nearest pairs of rooms Repair tries to route between for each component.
+static const int32 MaxRepairTries = 8;
+
+// Spread the set bits of Bits towards the high end through every bit set in Enter, a bit
+// being entered from the one below it. Doubling shifts, six steps for a whole word.
+static inline uint64_t spreadUp(uint64_t Bits, uint64_t Enter)
+{
+    Bits |= Enter & (Bits << 1);
+    Enter &= Enter << 1;
+    Bits |= Enter & (Bits << 2);
+    Enter &= Enter << 2;
+    Bits |= Enter & (Bits << 4);
+    Enter &= Enter << 4;
+    Bits |= Enter & (Bits << 8);
+    Enter &= Enter << 8;
+    Bits |= Enter & (Bits << 16);
+    Enter &= Enter << 16;
+    return Bits | (Enter & (Bits << 32));
+}
+
+// As spreadUp towards the low end, a bit being entered from the one above it.
+static inline uint64_t spreadDown(uint64_t Bits, uint64_t Enter)
+{
+    Bits |= Enter & (Bits >> 1);
+    Enter &= Enter >> 1;
+    Bits |= Enter & (Bits >> 2);
+    Enter &= Enter >> 2;
+    Bits |= Enter & (Bits >> 4);
+    Enter &= Enter >> 4;
+    Bits |= Enter & (Bits >> 8);
+    Enter &= Enter >> 8;
+    Bits |= Enter & (Bits >> 16);
+    Enter &= Enter >> 16;
+    return Bits | (Enter & (Bits >> 32));
+}
+
+/**
+ * Row by row flood fill. A tile is entered through its own edge on the side it is
+ * entered from, each edge being held by both tiles either side of it, and Doors
+ * when given adds edges to treat as open.
+ *
+ * Each queued row keeps the range of words that gained tiles since it was last
+ * visited, and a visit only walks out from that range as far as tiles keep
+ * spreading, so a corridor running down the map costs a word or two per row.
+ */
+class RowFill
+{
+public:
+    RowFill(const TileGrid& Tiles, const BitGrid* Doors)
+        : tiles(Tiles), doors(Doors), first(Tiles.Height(), INT_MAX), last(Tiles.Height(), -1) {}
+        
+    void Run(const IPoint& Seed, BitGrid& Reached)
+    {
+        if(!Reached.InBounds(Seed.X, Seed.Y) || !tiles.IsFloor(Seed.X, Seed.Y) || Reached.Get(Seed.X, Seed.Y)) return;
+        
+        Reached.Set(Seed.X, Seed.Y);
+        push(Seed.Y, Seed.X >> 6);
+        while(!rows.empty())
+        {
+            int32 y = rows.back();
+            rows.pop_back();
+            int32 lo = first[y];
+            int32 hi = last[y];
+            first[y] = INT_MAX;
+            last[y] = -1;
+            
+            spreadRow(Reached, y, lo, hi);
+            if(y > 0) spreadTo(Reached, y, y - 1, BottomWall, lo, hi);
+            if(y + 1 < tiles.Height()) spreadTo(Reached, y, y + 1, TopWall, lo, hi);
+        }
+    }
+    
+private:
+    const TileGrid& tiles;
+    const BitGrid* doors;
+    std::vector<int32> first;   // Words of each row that gained tiles, first > last when not queued.
+    std::vector<int32> last;
+    std::vector<int32> rows;
+    
+    void push(int32 y, int32 Word)
+    {
+        if(first[y] == INT_MAX) rows.push_back(y);
+        first[y] = min(first[y], Word);
+        last[y] = max(last[y], Word);
+    }
+    
+    // Tiles of word i in row y that can be entered through their Side edge.
+    uint64_t enter(int32 y, int32 i, int32 Side) const
+    {
+        uint64_t open = tiles.Plane(FloorPlane).Row(y)[i] & ~tiles.Plane(BlockedPlane + Side).Row(y)[i];
+        return (doors != nullptr) ? open | doors[Side].Row(y)[i] : open;
+    }
+    
+    // Spread along row y from words Lo to Hi, to the right then back to the left, widening
+    // Lo and Hi to every word that changed. Words outside them were already spread.
+    void spreadRow(BitGrid& Reached, int32 y, int32& Lo, int32& Hi)
+    {
+        uint64_t* row = Reached.Row(y);
+        int32 stride = Reached.Stride();
+        int32 end = Hi;
+        uint64_t carry = 0;
+        for(int32 i = Lo; i < stride; i++)
+        {
+            uint64_t e = enter(y, i, LeftWall);
+            uint64_t bits = spreadUp(row[i] | (carry & e & 1), e);
+            if(i > Hi && bits == row[i]) break;
+            
+            row[i] = bits;
+            end = i;
+            carry = bits >> 63;
+        }
+        Hi = end;
+        
+        int32 start = Lo;
+        carry = 0;
+        for(int32 i = Hi; i >= 0; i--)
+        {
+            uint64_t e = enter(y, i, RightWall);
+            uint64_t bits = spreadDown(row[i] | ((carry << 63) & e), e);
+            if(i < Lo && bits == row[i]) break;
+            
+            row[i] = bits;
+            start = i;
+            carry = bits & 1;
+        }
+        Lo = start;
+    }
+    
+    // Carry words Lo to Hi of row From into row To, entering To's tiles through their Side edge.
+    void spreadTo(BitGrid& Reached, int32 From, int32 To, int32 Side, int32 Lo, int32 Hi)
+    {
+        const uint64_t* from = Reached.Row(From);
+        uint64_t* to = Reached.Row(To);
+        for(int32 i = Lo; i <= Hi; i++)
+        {
+            uint64_t add = from[i] & ~to[i];
+            if(add == 0) continue;
+            
+            add &= enter(To, i, Side);
+            if(add == 0) continue;
+            to[i] |= add;
+            push(To, i);
+        }
+    }
+};
+
+static int32 countBits(const BitGrid& Grid)
+{
+    int32 n = 0;
+    for(int32 y = 0; y < Grid.Height(); y++)
+    {
+        const uint64_t* row = Grid.Row(y);
+        for(int32 i = 0; i < Grid.Stride(); i++)
+        {
+            n += __builtin_popcountll(row[i]);
+        }
+    }
+    return n;
+}
+
+void MapValidator::Fill(const TileGrid& Tiles, const IPoint& Seed, BitGrid& Reached)
+{
+    RowFill fill(Tiles, nullptr);
+    fill.Run(Seed, Reached);
+}
+
+bool MapValidator::Check(const MapInfoType& MapInfo, const TileGrid& Tiles, ConnectivityReport& Report)
+{
+    static const int32 opposite[4] = { BottomWall, LeftWall, TopWall, RightWall };
+    static const int32 stepX[4] = { 0, 1, 0, -1 };
+    static const int32 stepY[4] = { -1, 0, 1, 0 };
+    
+    int32 w = Tiles.Width();
+    int32 h = Tiles.Height();
+    const IPoint& origin = Tiles.Origin();
+    
+    // Every door's edge, on both tiles that share it.
+    BitGrid doors[4];
+    for(int32 side = TopWall; side <= LeftWall; side++)
+    {
+        doors[side].Resize(w, h);
+    }
+    for(const Door* d : MapInfo.Doors)
+    {
+        int32 x = d->X - origin.X;
+        int32 y = d->Y - origin.Y;
+        int32 nx = x + stepX[d->Wall];
+        int32 ny = y + stepY[d->Wall];
+        if(Tiles.Plane(FloorPlane).InBounds(x, y) && Tiles.IsFloor(x, y)) doors[d->Wall].Set(x, y);
+        if(Tiles.Plane(FloorPlane).InBounds(nx, ny) && Tiles.IsFloor(nx, ny)) doors[opposite[d->Wall]].Set(nx, ny);
+    }
+    
+    // Fill from the first room not yet reached until every room has a component. The
+    // components never meet, so they can share one grid of reached tiles.
+    int32 nRooms = MapInfo.Rooms.size();
+    Report.Components = 0;
+    Report.Main = -1;
+    Report.Component.assign(nRooms, -1);
+    Report.Unreachable.clear();
+    
+    vector<IPoint> seeds(nRooms);
+    for(int32 i = 0; i < nRooms; i++)
+    {
+        const Room* r = MapInfo.Rooms[i];
+        const IRect& b = r->Bounds;
+        int32 x = min(max(b.CenterX() - origin.X, 0), w - 1);
+        int32 y = min(max(b.CenterY() - origin.Y, 0), h - 1);
+        bool inside = r->Enabled && w > 0 && h > 0 && b.Right() - origin.X >= x && b.Left() - origin.X <= x &&
+                      b.Bottom() - origin.Y >= y && b.Top() - origin.Y <= y;
+        seeds[i] = inside ? IPoint(x, y) : IPoint(-1, -1);
+    }
+    
+    BitGrid reached(w, h);
+    RowFill fill(Tiles, doors);
+    vector<int32> sizes;
+    for(int32 i = 0; i < nRooms; i++)
+    {
+        if(Report.Component[i] != -1 || seeds[i].X < 0) continue;
+        
+        fill.Run(seeds[i], reached);
+        int32 size = 0;
+        for(int32 k = i; k < nRooms; k++)
+        {
+            if(Report.Component[k] == -1 && seeds[k].X >= 0 && reached.Get(seeds[k].X, seeds[k].Y))
+            {
+                Report.Component[k] = Report.Components;
+                size++;
+            }
+        }
+        sizes.push_back(size);
+        if(Report.Main == -1 || size > sizes[Report.Main])
+        {
+            Report.Main = Report.Components;
+        }
+        Report.Components++;
+    }
+    
+    for(int32 i = 0; i < nRooms; i++)
+    {
+        if(Report.Component[i] != -1 && Report.Component[i] != Report.Main)
+        {
+            Report.Unreachable.push_back(i);
+        }
+    }
+    
+    // Count the main component's tiles on a fill of its own.
+    Report.FloorTiles = countBits(Tiles.Plane(FloorPlane));
+    Report.ReachedTiles = 0;
+    if(Report.Components == 1)
+    {
+        Report.ReachedTiles = countBits(reached);
+    }
+    else if(Report.Components > 1)
+    {
+        reached.Clear();
+        int32 first = find(Report.Component.begin(), Report.Component.end(), Report.Main) - Report.Component.begin();
+        fill.Run(seeds[first], reached);
+        Report.ReachedTiles = countBits(reached);
+    }
+    return Report.Components <= 1;
+}
+
+int32 MapValidator::Repair(MapInfoType& MapInfo, const ConnectivityReport& Report, CorridorRouting Routing)
+{
+    if(Report.Components <= 1) return 0;
+    
+    int32 nRooms = MapInfo.Rooms.size();
+    vector<bool> joined(Report.Components, false);
+    joined[Report.Main] = true;
+    
+    // Components are joined in order, each to the nearest room that can be routed to of
+    // the ones joined before it. Routes that fail are not laid straight, as a straight
+    // corridor between them is what may have left the rooms apart.
+    CorridorRouter router(MapInfo);
+    RouteWorkspace work;
+    vector<pair<int32, pair<int32, int32> > > pairs;
+    vector<IPoint> path;
+    int32 added = 0;
+    for(int32 c = 0; c < Report.Components; c++)
+    {
+        if(joined[c]) continue;
+        
+        pairs.clear();
+        for(int32 a = 0; a < nRooms; a++)
+        {
+            if(Report.Component[a] != c) continue;
+            
+            const IRect& ra = MapInfo.Rooms[a]->Bounds;
+            for(int32 b = 0; b < nRooms; b++)
+            {
+                if(Report.Component[b] == -1 || !joined[Report.Component[b]]) continue;
+                
+                const IRect& rb = MapInfo.Rooms[b]->Bounds;
+                int32 distance = abs(ra.CenterX() - rb.CenterX()) + abs(ra.CenterY() - rb.CenterY());
+                
+                // Only the closest MaxRepairTries pairs are kept, in a max heap, so two large
+                // components never hold every pair between them.
+                pair<int32, pair<int32, int32> > candidate(distance, make_pair(a, b));
+                if((int32)pairs.size() < MaxRepairTries)
+                {
+                    pairs.push_back(candidate);
+                    push_heap(pairs.begin(), pairs.end());
+                }
+                else if(candidate < pairs.front())
+                {
+                    pop_heap(pairs.begin(), pairs.end());
+                    pairs.back() = candidate;
+                    push_heap(pairs.begin(), pairs.end());
+                }
+            }
+        }
+        sort_heap(pairs.begin(), pairs.end());
+        int32 tries = pairs.size();
+        
+        for(int32 t = 0; t < tries; t++)
+        {
+            const IRect& ra = MapInfo.Rooms[pairs[t].second.first]->Bounds;
+            const IRect& rb = MapInfo.Rooms[pairs[t].second.second]->Bounds;
+            CorridorEndpoints ends(2);
+            ends.Set(0, ra, rb);
+            ends.Set(1, rb, ra);
+            ends.Solve();
+            
+            IPoint start(ends.OutX[0], ends.OutY[0]);
+            IPoint end(ends.OutX[1], ends.OutY[1]);
+            path.clear();
+            bool routed = (Routing == JumpPointRouting) ? router.RouteJumpPoint(start, end, path, work) : router.Route(start, end, path, work);
+            if(!routed) continue;
+            
+            Corridor* corridor = new Corridor();
+            corridor->SX = start.X;
+            corridor->SY = start.Y;
+            corridor->EX = end.X;
+            corridor->EY = end.Y;
+            corridor->Path = path;
+            corridor->UpdateBounds();
+            router.MarkPath(corridor->Path);
+            MapInfo.Corridors.push_back(corridor);
+            joined[c] = true;
+            added++;
+            break;
+        }
+    }
+    
+    if(added > 0)
+    {
+        UMapBuilderLib::PlaceDoors(MapInfo);
+        UMapBuilderLib::LinkCorridorFeatures(MapInfo);
+    }
+    return added;
+}
+
+bool MapValidator::Validate(MapInfoType& MapInfo, ConnectivityReport& Report, CorridorRouting Routing, int32 MaxPasses)
+{
+    TileGrid tiles;
+    for(int32 pass = 0; ; pass++)
+    {
+        tiles.Rasterise(MapInfo);
+        if(Check(MapInfo, tiles, Report) || pass == MaxPasses) break;
+        if(Repair(MapInfo, Report, Routing) == 0) break;
+    }
+    return Report.Components <= 1;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "BitGrid.h"
+#include "TileGrid.h"
+#include "MapModel.h"
+#include "CorridorRouter.h"
+#include "Helper.h"
+
+/** What MapValidator::Check found, rooms indexed as in MapInfo.Rooms. **/
+typedef struct
+{
+    int32 Components;                   /** Separate groups of rooms, 1 when the map is connected. **/
+    int32 Main;                         /** The component holding the most rooms. **/
+    std::vector<int32> Component;       /** Component of each room, -1 for rooms outside the grid. **/
+    std::vector<int32> Unreachable;     /** Rooms not in the main component. **/
+    int32 FloorTiles;
+    int32 ReachedTiles;                 /** Floor tiles joined to the main component. **/
+} ConnectivityReport;
+
+/**
+ * Checks every room of a rasterised map can be walked to from every other.
+ *
+ * The fill works on the TileGrid's bit planes a row of words at a time: each
+ * row is spread sideways through open edges with shifts, then pushed into the
+ * rows above and below, and only rows that gained tiles are visited again. A
+ * map is filled in a few passes over its words, cheap enough to run on every
+ * generated map.
+ */
+class MapValidator
+{
+public:
+    /**
+     * Label the rooms of MapInfo by the floor they share in Tiles. Doors count as open
+     * whatever their state, a closed door still joins the tiles either side of it.
+     * Returns true if the rooms are all in one component.
+     */
+    static bool Check(const MapInfoType& MapInfo, const TileGrid& Tiles, ConnectivityReport& Report);
+    
+    /**
+     * Set in Reached every tile that can be walked to from the tile at Seed through the
+     * edges as they are, so closed doors stop the fill. Seed is set itself if it is floor.
+     * Reached must be the size of Tiles and is not cleared first.
+     */
+    static void Fill(const TileGrid& Tiles, const IPoint& Seed, BitGrid& Reached);
+    
+    /**
+     * Join each component outside the main one to the rooms already joined, by a corridor
+     * routed between the nearest pair of rooms a route can be found for, then place the
+     * doors again. Straight routing is taken as A*. Returns the corridors added.
+     */
+    static int32 Repair(MapInfoType& MapInfo, const ConnectivityReport& Report, CorridorRouting Routing = AStarRouting);
+    
+    /**
+     * Rasterise, check and repair until MapInfo is connected or MaxPasses repairs have been
+     * made. Report holds the last check. Returns true if the map ended up connected.
+     */
+    static bool Validate(MapInfoType& MapInfo, ConnectivityReport& Report, CorridorRouting Routing = AStarRouting, int32 MaxPasses = 3);
+};
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "MapVertices.h"
+#include <cmath>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+const int32 MapVertexBuilder::BoxFillVertices;
+const int32 MapVertexBuilder::BoxLineVertices;
+const int32 MapVertexBuilder::PointSides;
+const int32 MapVertexBuilder::PointVertices;
+const int32 MapVertexBuilder::DensityCells;
+
+// Room centres are drawn this size whatever the scale.
+static const float PointRadius = 3.f;
+
+static inline MapVertex vertex(float x, float y, const MapColour& Colour)
+{
+    MapVertex v = { x, y, Colour };
+    return v;
+}
+
+int32 MapVertexBuilder::ItemVertices(MapLayer Layer)
+{
+    switch(Layer)
+    {
+        case RoomFillLayer:
+        case FeatureFillLayer:
+        case DoorLayer:
+        case DensityLayer:
+            return BoxFillVertices;
+        case RoomLineLayer:
+        case FeatureLineLayer:
+            return BoxLineVertices;
+        case RoomPointLayer:
+            return PointVertices;
+        default:
+            return 2;
+    }
+}
+
+void MapVertexBuilder::ClearAll()
+{
+    for(int32 i = 0; i < MapLayerCount; i++)
+    {
+        Clear((MapLayer)i);
+    }
+}
+
+void MapVertexBuilder::Query(MapLayer Layer, const IRect& View, vector<int32>& Items) const
+{
+    // Outlines are the same items as their fills, so only the fills are indexed.
+    if(Layer == RoomLineLayer) Layer = RoomFillLayer;
+    else if(Layer == FeatureLineLayer) Layer = FeatureFillLayer;
+    
+    index[Layer].Query(View, Items);
+}
+
+void MapVertexBuilder::indexLayer(MapLayer Layer)
+{
+    const vector<MapVertex>& v = layers[Layer];
+    int32 n = ItemVertices(Layer);
+    boxes.clear();
+    boxes.reserve(v.size() / n);
+    for(size_t i = 0; i + n <= v.size(); i += n)
+    {
+        float x0 = v[i].X, y0 = v[i].Y, x1 = x0, y1 = y0;
+        for(int32 k = 1; k < n; k++)
+        {
+            x0 = min(x0, v[i + k].X);
+            y0 = min(y0, v[i + k].Y);
+            x1 = max(x1, v[i + k].X);
+            y1 = max(y1, v[i + k].Y);
+        }
+        
+        int32 left = (int32)floor(x0);
+        int32 top = (int32)floor(y0);
+        boxes.push_back(IRect(left, top, (int32)ceil(x1) - left, (int32)ceil(y1) - top));
+    }
+    
+    index[Layer].Build(boxes);
+}
+
+void MapVertexBuilder::line(MapLayer Layer, float x0, float y0, float x1, float y1, const MapColour& Colour)
+{
+    layers[Layer].push_back(vertex(x0, y0, Colour));
+    layers[Layer].push_back(vertex(x1, y1, Colour));
+}
+
+void MapVertexBuilder::quad(MapLayer Layer, float x0, float y0, float x1, float y1, const MapColour& Colour)
+{
+    vector<MapVertex>& fill = layers[Layer];
+    fill.push_back(vertex(x0, y0, Colour));
+    fill.push_back(vertex(x1, y0, Colour));
+    fill.push_back(vertex(x1, y1, Colour));
+    fill.push_back(vertex(x0, y0, Colour));
+    fill.push_back(vertex(x1, y1, Colour));
+    fill.push_back(vertex(x0, y1, Colour));
+}
+
+// Filled box with an outline, as main.cpp drew rooms with a RectangleShape and four lines.
+void MapVertexBuilder::box(MapLayer Fill, MapLayer Line, const IRect& Bounds, const MapColour& FillColour, const MapColour& LineColour)
+{
+    float x0 = Bounds.Position.X * scale;
+    float y0 = Bounds.Position.Y * scale;
+    float x1 = (Bounds.Position.X + Bounds.Width) * scale;
+    float y1 = (Bounds.Position.Y + Bounds.Height) * scale;
+    
+    quad(Fill, x0, y0, x1, y1, FillColour);
+    line(Line, x0, y0, x1, y0, LineColour);
+    line(Line, x0, y0, x0, y1, LineColour);
+    line(Line, x1, y1, x0, y1, LineColour);
+    line(Line, x1, y1, x1, y0, LineColour);
+}
+
+void MapVertexBuilder::BuildRooms(const MapInfoType& MapInfo)
+{
+    layers[RoomFillLayer].clear();
+    layers[RoomLineLayer].clear();
+    layers[RoomFillLayer].reserve(MapInfo.Rooms.size() * BoxFillVertices);
+    layers[RoomLineLayer].reserve(MapInfo.Rooms.size() * BoxLineVertices);
+    for(const Room* r : MapInfo.Rooms)
+    {
+        box(RoomFillLayer, RoomLineLayer, r->Bounds, RoomFillColour, RoomLineColour);
+    }
+    indexLayer(RoomFillLayer);
+    
+    layers[DensityLayer].clear();
+    extent = IRect();
+    if(MapInfo.Rooms.empty())
+    {
+        index[DensityLayer] = BVH();
+        return;
+    }
+    
+    int32 left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+    for(const Room* r : MapInfo.Rooms)
+    {
+        left = min(left, r->Bounds.Left());
+        top = min(top, r->Bounds.Top());
+        right = max(right, r->Bounds.Right());
+        bottom = max(bottom, r->Bounds.Bottom());
+    }
+    extent = IRect((int32)floor(left * scale), (int32)floor(top * scale),
+                   (int32)ceil(right * scale) - (int32)floor(left * scale), (int32)ceil(bottom * scale) - (int32)floor(top * scale));
+    
+    // Tiles of each square covered by rooms, overlapping rooms counted twice.
+    int32 cell = max(1, (max(right - left, bottom - top) + DensityCells - 1) / DensityCells);
+    int32 cols = (right - left + cell - 1) / cell;
+    int32 rows = (bottom - top + cell - 1) / cell;
+    vector<int64_t> covered((size_t)max(cols, 1) * max(rows, 1), 0);
+    for(const Room* r : MapInfo.Rooms)
+    {
+        const IRect& b = r->Bounds;
+        for(int32 cy = (b.Top() - top) / cell; cy * cell + top < b.Bottom(); cy++)
+        {
+            int32 h = min(b.Bottom(), top + (cy + 1) * cell) - max(b.Top(), top + cy * cell);
+            for(int32 cx = (b.Left() - left) / cell; cx * cell + left < b.Right(); cx++)
+            {
+                int32 w = min(b.Right(), left + (cx + 1) * cell) - max(b.Left(), left + cx * cell);
+                covered[(size_t)cy * cols + cx] += (int64_t)w * h;
+            }
+        }
+    }
+    
+    // Squares fade from faint to the room colour as they fill.
+    double area = (double)cell * cell;
+    for(int32 cy = 0; cy < rows; cy++)
+    {
+        for(int32 cx = 0; cx < cols; cx++)
+        {
+            int64_t c = covered[(size_t)cy * cols + cx];
+            if(c == 0) continue;
+            
+            MapColour colour = RoomFillColour;
+            colour.A = (uint8_t)(64 + 191 * min(1.0, c / area));
+            float x0 = (left + cx * cell) * scale;
+            float y0 = (top + cy * cell) * scale;
+            quad(DensityLayer, x0, y0, x0 + cell * scale, y0 + cell * scale, colour);
+        }
+    }
+    indexLayer(DensityLayer);
+}
+
+void MapVertexBuilder::BuildCorridorFeatures(const MapInfoType& MapInfo)
+{
+    layers[FeatureFillLayer].clear();
+    layers[FeatureLineLayer].clear();
+    layers[FeatureFillLayer].reserve(MapInfo.CorridorFeatures.size() * BoxFillVertices);
+    layers[FeatureLineLayer].reserve(MapInfo.CorridorFeatures.size() * BoxLineVertices);
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        box(FeatureFillLayer, FeatureLineLayer, f->Bounds, CorridorFillColour, CorridorLineColour);
+    }
+    indexLayer(FeatureFillLayer);
+}
+
+void MapVertexBuilder::BuildDelaunay(const Triangulation& Tri)
+{
+    // Each point is a small polygon, one triangle per side around its centre.
+    float cs[PointSides + 1], sn[PointSides + 1];
+    for(int32 k = 0; k <= PointSides; k++)
+    {
+        double a = 2.0 * M_PI * k / PointSides;
+        cs[k] = (float)cos(a) * PointRadius;
+        sn[k] = (float)sin(a) * PointRadius;
+    }
+    
+    vector<MapVertex>& points = layers[RoomPointLayer];
+    points.clear();
+    points.reserve(Tri.nPoints * PointVertices);
+    for(int32 i = 0; i < Tri.nPoints; i++)
+    {
+        float x = Tri.point[i]->X * scale;
+        float y = Tri.point[i]->Y * scale;
+        for(int32 k = 0; k < PointSides; k++)
+        {
+            points.push_back(vertex(x, y, RoomPointColour));
+            points.push_back(vertex(x + cs[k], y + sn[k], RoomPointColour));
+            points.push_back(vertex(x + cs[k + 1], y + sn[k + 1], RoomPointColour));
+        }
+    }
+    
+    layers[DelaunayLayer].clear();
+    layers[DelaunayLayer].reserve(Tri.nEdges * 2);
+    for(int32 i = 0; i < Tri.nEdges; i++)
+    {
+        const FPoint* a = Tri.point[Tri.edge[i]->s];
+        const FPoint* b = Tri.point[Tri.edge[i]->t];
+        line(DelaunayLayer, a->X * scale, a->Y * scale, b->X * scale, b->Y * scale, DelaunayLineColour);
+    }
+    indexLayer(RoomPointLayer);
+    indexLayer(DelaunayLayer);
+}
+
+void MapVertexBuilder::BuildMinSpan(const list<int32>& MinSpan, const vector<FPoint*>& Points)
+{
+    layers[MinSpanLayer].clear();
+    layers[MinSpanLayer].reserve(MinSpan.size());
+    for(auto itr = MinSpan.begin(); itr != MinSpan.end(); itr++)
+    {
+        const FPoint* a = Points[*itr++];
+        if(itr == MinSpan.end()) break;
+        const FPoint* b = Points[*itr];
+        line(MinSpanLayer, a->X * scale, a->Y * scale, b->X * scale, b->Y * scale, FinalEdgeLineColour);
+    }
+    indexLayer(MinSpanLayer);
+}
+
+void MapVertexBuilder::BuildCorridors(const MapInfoType& MapInfo)
+{
+    // Each corridor's line strip becomes separate segments, so every corridor goes in one call.
+    layers[CorridorLayer].clear();
+    for(const Corridor* c : MapInfo.Corridors)
+    {
+        for(size_t i = 1; i < c->Path.size(); i++)
+        {
+            line(CorridorLayer, c->Path[i - 1].X * scale, c->Path[i - 1].Y * scale, c->Path[i].X * scale, c->Path[i].Y * scale, CorridorLineColour);
+        }
+    }
+    
+    vector<MapVertex>& doors = layers[DoorLayer];
+    doors.clear();
+    doors.reserve(MapInfo.Doors.size() * BoxFillVertices);
+    float size = max(scale, 1.f);
+    for(const Door* d : MapInfo.Doors)
+    {
+        float x0 = d->X * scale;
+        float y0 = d->Y * scale;
+        quad(DoorLayer, x0, y0, x0 + size, y0 + size, DoorColour);
+    }
+    indexLayer(CorridorLayer);
+    indexLayer(DoorLayer);
+}
\ No newline at end of file
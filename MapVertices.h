@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <list>
+#include "MapModel.h"
+#include "MapColours.h"
+#include "FPoint.h"
+#include "Delaunay.h"
+#include "BVH.h"
+#include "Helper.h"
+
+/** A corner of a line or triangle, in window pixels. **/
+typedef struct
+{
+    float X, Y;
+    MapColour Colour;
+} MapVertex;
+
+/** Vertex buffers a map view draws, bottom to top. **/
+enum MapLayer
+{
+    RoomFillLayer,      /** Triangles, BoxFillVertices per room. **/
+    RoomLineLayer,      /** Lines, BoxLineVertices per room. **/
+    FeatureFillLayer,   /** Triangles, BoxFillVertices per corridor feature. **/
+    FeatureLineLayer,   /** Lines, BoxLineVertices per corridor feature. **/
+    RoomPointLayer,     /** Triangles, PointVertices per room centre. **/
+    DelaunayLayer,      /** Lines, two vertices per edge. **/
+    MinSpanLayer,       /** Lines, two vertices per edge. **/
+    CorridorLayer,      /** Lines, two vertices per corridor segment. **/
+    DoorLayer,          /** Triangles, BoxFillVertices per door. **/
+    DensityLayer,       /** Triangles, BoxFillVertices per square of the density grid holding rooms, drawn in place of the rest when zoomed far out. **/
+    MapLayerCount
+};
+
+/**
+ * Builds the vertex buffers for drawing a map, one per MapLayer, with no tie to
+ * a window. Each layer is drawn with one call, as a list of separate triangles
+ * or separate lines, so a view only rebuilds a layer when what it shows has
+ * changed. Buffers keep their memory between builds.
+ *
+ * Rooms and corridor features are drawn in the order they are stored, so the
+ * first n of them are the first n * BoxFillVertices or BoxLineVertices vertices
+ * of their layers.
+ *
+ * Each layer is a run of items, ItemVertices(Layer) vertices apiece, and a BVH
+ * over the items' bounds finds the ones inside a view, so a view of a small part
+ * of a large map only draws that part.
+ */
+class MapVertexBuilder
+{
+public:
+    static const int32 BoxFillVertices = 6;     // Two triangles.
+    static const int32 BoxLineVertices = 8;     // Four lines.
+    static const int32 PointSides = 8;
+    static const int32 PointVertices = PointSides * 3;
+    static const int32 DensityCells = 256;      // Squares across the longer side of the rooms' extent.
+    
+    explicit MapVertexBuilder(float Scale = 1.f) : scale(Scale) {}
+    
+    /** Map tile (x, y) is drawn at pixel (x * Scale, y * Scale). Layers already built keep the old scale. **/
+    void SetScale(float Scale) { scale = Scale; }
+    float Scale() const { return scale; }
+    
+    /** True if Layer is drawn as triangles, false for lines. **/
+    static bool IsTriangles(MapLayer Layer)
+    {
+        return Layer == RoomFillLayer || Layer == FeatureFillLayer || Layer == RoomPointLayer || Layer == DoorLayer || Layer == DensityLayer;
+    }
+    
+    /** Vertices making up each item of Layer. **/
+    static int32 ItemVertices(MapLayer Layer);
+    
+    const std::vector<MapVertex>& Layer(MapLayer Layer) const { return layers[Layer]; }
+    void Clear(MapLayer Layer) { layers[Layer].clear(); index[Layer] = BVH(); }
+    void ClearAll();
+    
+    /**
+     * Indices of the items of Layer overlapping View, in ascending order. View is in the
+     * same pixels as the vertices. The line layers of rooms and corridor features share
+     * the items of their fill layers.
+     */
+    void Query(MapLayer Layer, const IRect& View, std::vector<int32>& Items) const;
+    
+    /** Bounds of every room, in pixels, as of the last BuildRooms. **/
+    const IRect& Extent() const { return extent; }
+    
+    /** RoomFillLayer, RoomLineLayer and DensityLayer, the density grid shaded by the share of each square rooms cover. **/
+    void BuildRooms(const MapInfoType& MapInfo);
+    
+    /** FeatureFillLayer and FeatureLineLayer. **/
+    void BuildCorridorFeatures(const MapInfoType& MapInfo);
+    
+    /** RoomPointLayer and DelaunayLayer from the points and edges of Tri. **/
+    void BuildDelaunay(const Triangulation& Tri);
+    
+    /** MinSpanLayer from index pairs into Points, as returned by CalcMinSpan. **/
+    void BuildMinSpan(const std::list<int32>& MinSpan, const std::vector<FPoint*>& Points);
+    
+    /** CorridorLayer and DoorLayer. **/
+    void BuildCorridors(const MapInfoType& MapInfo);
+    
+private:
+    float scale;
+    IRect extent;
+    std::vector<MapVertex> layers[MapLayerCount];
+    BVH index[MapLayerCount];
+    std::vector<IRect> boxes;
+    
+    void quad(MapLayer Layer, float x0, float y0, float x1, float y1, const MapColour& Colour);
+    void box(MapLayer Fill, MapLayer Line, const IRect& Bounds, const MapColour& FillColour, const MapColour& LineColour);
+    void line(MapLayer Layer, float x0, float y0, float x1, float y1, const MapColour& Colour);
+    
+    // Rebuild the index of Layer from the bounds of its items.
+    void indexLayer(MapLayer Layer);
+};
\ No newline at end of file
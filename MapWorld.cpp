@@ -0,0 +1,273 @@
+#include "MapWorld.h"
+#include "CounterRand.h"
+#include <algorithm>
+
+using namespace std;
+
+static uint64_t hashRegion(int32 WorldSeed, int32 rx, int32 ry, int32 Salt)
+{
+    return Mix64(Mix64(Mix64((uint32_t)WorldSeed) ^ (uint32_t)rx) ^ (((uint64_t)(uint32_t)ry << 32) | (uint32_t)Salt));
+}
+
+// Memory held by a map, near enough for the cache budget.
+static size_t mapBytes(const MapInfoType& MapInfo)
+{
+    size_t bytes = sizeof(MapInfoType);
+    for(const Room* r : MapInfo.Rooms)
+    {
+        bytes += sizeof(Room*) + sizeof(Room) + r->Corridors.capacity() * sizeof(Corridor*);
+    }
+    for(const Corridor* c : MapInfo.Corridors)
+    {
+        bytes += sizeof(Corridor*) + sizeof(Corridor) + c->Path.capacity() * sizeof(IPoint) + c->Features.capacity() * sizeof(CorridorFeature*);
+    }
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        bytes += sizeof(CorridorFeature*) + sizeof(CorridorFeature) + f->Corridors.capacity() * sizeof(Corridor*);
+    }
+    bytes += MapInfo.Doors.size() * (sizeof(Door*) + sizeof(Door));
+    return bytes;
+}
+
+// Move everything in a map by (dx, dy).
+static void offsetMap(MapInfoType& MapInfo, int32 dx, int32 dy)
+{
+    IPoint offset(dx, dy);
+    for(Room* r : MapInfo.Rooms)
+    {
+        r->Bounds.Position += offset;
+    }
+    for(Corridor* c : MapInfo.Corridors)
+    {
+        c->SX += dx;
+        c->SY += dy;
+        c->EX += dx;
+        c->EY += dy;
+        c->Bounds.Position += offset;
+        for(IPoint& p : c->Path)
+        {
+            p += offset;
+        }
+    }
+    for(CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        f->Bounds.Position += offset;
+    }
+    for(Door* d : MapInfo.Doors)
+    {
+        d->X += dx;
+        d->Y += dy;
+    }
+}
+
+MapWorld::MapWorld(int32 WorldSeed, const GenerationParams& RegionParams, size_t MemoryBudget, int32 PrefetchRadius)
+{
+    seed = WorldSeed;
+    params = RegionParams;
+    budget = MemoryBudget;
+    radius = max(PrefetchRadius, 0);
+    used = 0;
+    focusChanged = false;
+    busy = false;
+    stop = false;
+    worker = thread(&MapWorld::Prefetch, this);
+}
+
+MapWorld::~MapWorld()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+int32 MapWorld::RegionSeed(int32 WorldSeed, int32 rx, int32 ry)
+{
+    // Kept to 1 .. 2^31 - 2 so it is also a valid PseudoRand seed.
+    return (int32)(hashRegion(WorldSeed, rx, ry, 0) % 2147483646) + 1;
+}
+
+IPoint MapWorld::RegionOf(int32 x, int32 y) const
+{
+    // Round down for negative tiles.
+    int32 rx = (x >= 0) ? x / params.Width : -((-x + params.Width - 1) / params.Width);
+    int32 ry = (y >= 0) ? y / params.Height : -((-y + params.Height - 1) / params.Height);
+    return IPoint(rx, ry);
+}
+
+IPoint MapWorld::Connector(int32 rx, int32 ry, int32 Side) const
+{
+    // Each edge is named by the region above or left of it, so both regions sharing it find the same cell.
+    int32 w = params.Width;
+    int32 h = params.Height;
+    int32 spanX = max(w - 2 * params.Margin, 1);
+    int32 spanY = max(h - 2 * params.Margin, 1);
+    
+    if(Side == LeftWall || Side == RightWall)
+    {
+        int32 edgeX = (Side == LeftWall) ? rx - 1 : rx;
+        int32 y = ry * h + min(params.Margin, h - 1) + (int32)(hashRegion(seed, edgeX, ry, 1) % spanY);
+        return IPoint((Side == LeftWall) ? rx * w : rx * w + w - 1, y);
+    }
+    
+    int32 edgeY = (Side == TopWall) ? ry - 1 : ry;
+    int32 x = rx * w + min(params.Margin, w - 1) + (int32)(hashRegion(seed, rx, edgeY, 2) % spanX);
+    return IPoint(x, (Side == TopWall) ? ry * h : ry * h + h - 1);
+}
+
+shared_ptr<const WorldRegion> MapWorld::Generate(int32 rx, int32 ry) const
+{
+    shared_ptr<WorldRegion> region = make_shared<WorldRegion>(rx, ry);
+    region->Bounds = IRect(rx * params.Width, ry * params.Height, params.Width, params.Height);
+    
+    // Generated at the origin, then moved into place.
+    vector<IPoint> connectors;
+    for(int32 side = TopWall; side <= LeftWall; side++)
+    {
+        IPoint p = Connector(rx, ry, side);
+        connectors.push_back(IPoint(p.X - region->Bounds.Left(), p.Y - region->Bounds.Top()));
+    }
+    
+    // Every random number comes from the region's own seed, so regions can be generated on any number of threads at once.
+    UMapBuilderLib::GenerateMap(region->Map, params, RegionSeed(seed, rx, ry), &connectors);
+    offsetMap(region->Map, region->Bounds.Left(), region->Bounds.Top());
+    region->Bytes = mapBytes(region->Map);
+    return region;
+}
+
+shared_ptr<const WorldRegion> MapWorld::Insert(const shared_ptr<const WorldRegion>& Region)
+{
+    // The lock is held. Another thread may have generated the same region meanwhile, the first one stays.
+    uint64_t key = Key(Region->X, Region->Y);
+    auto found = cache.find(key);
+    if(found != cache.end())
+    {
+        return found->second.Region;
+    }
+    
+    uses.push_front(key);
+    CacheEntry entry = { Region, uses.begin() };
+    cache[key] = entry;
+    used += Region->Bytes;
+    
+    // Evict the least recently used regions, but never the one just added.
+    while(used > budget && uses.back() != key)
+    {
+        auto evict = cache.find(uses.back());
+        used -= evict->second.Region->Bytes;
+        cache.erase(evict);
+        uses.pop_back();
+    }
+    return Region;
+}
+
+shared_ptr<const WorldRegion> MapWorld::FindRegion(int32 rx, int32 ry)
+{
+    lock_guard<mutex> guard(lock);
+    auto found = cache.find(Key(rx, ry));
+    if(found == cache.end())
+    {
+        return shared_ptr<const WorldRegion>();
+    }
+    
+    uses.splice(uses.begin(), uses, found->second.Use);
+    return found->second.Region;
+}
+
+shared_ptr<const WorldRegion> MapWorld::Region(int32 rx, int32 ry)
+{
+    shared_ptr<const WorldRegion> region = FindRegion(rx, ry);
+    if(region)
+    {
+        return region;
+    }
+    
+    region = Generate(rx, ry);
+    lock_guard<mutex> guard(lock);
+    return Insert(region);
+}
+
+void MapWorld::SetFocus(int32 x, int32 y)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        focus = RegionOf(x, y);
+        focusChanged = true;
+    }
+    wake.notify_all();
+}
+
+void MapWorld::WaitForPrefetch()
+{
+    unique_lock<mutex> guard(lock);
+    wake.wait(guard, [this]() { return stop || (!focusChanged && !busy); });
+}
+
+int32 MapWorld::CachedRegions()
+{
+    lock_guard<mutex> guard(lock);
+    return cache.size();
+}
+
+size_t MapWorld::MemoryUsed()
+{
+    lock_guard<mutex> guard(lock);
+    return used;
+}
+
+void MapWorld::Prefetch()
+{
+    unique_lock<mutex> guard(lock);
+    while(!stop)
+    {
+        if(!focusChanged)
+        {
+            busy = false;
+            wake.notify_all();
+            wake.wait(guard, [this]() { return stop || focusChanged; });
+            continue;
+        }
+        focusChanged = false;
+        busy = true;
+        
+        // Regions around the focus, nearest first.
+        vector<IPoint> wanted;
+        for(int32 dy = -radius; dy <= radius; dy++)
+        {
+            for(int32 dx = -radius; dx <= radius; dx++)
+            {
+                wanted.push_back(IPoint(dx, dy));
+            }
+        }
+        stable_sort(wanted.begin(), wanted.end(), [](const IPoint& a, const IPoint& b)
+        {
+            return (a.X * a.X + a.Y * a.Y) < (b.X * b.X + b.Y * b.Y);
+        });
+        
+        IPoint centre = focus;
+        for(const IPoint& d : wanted)
+        {
+            // Start again from the new focus as soon as it moves.
+            if(stop || focusChanged) break;
+            
+            int32 rx = centre.X + d.X;
+            int32 ry = centre.Y + d.Y;
+            auto found = cache.find(Key(rx, ry));
+            if(found != cache.end())
+            {
+                // Keep regions near the focus at the front of the cache.
+                uses.splice(uses.begin(), uses, found->second.Use);
+                continue;
+            }
+            
+            guard.unlock();
+            shared_ptr<const WorldRegion> region = Generate(rx, ry);
+            guard.lock();
+            Insert(region);
+        }
+    }
+    busy = false;
+    wake.notify_all();
+}
\ No newline at end of file
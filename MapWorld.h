@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <stdint.h>
+#include "MapModel.h"
+#include "MapBuilderLib.h"
+#include "Helper.h"
+
+/**
+ * One generated region of a MapWorld. Everything in Map is in world tile
+ * coordinates, Map.Width and Map.Height give the size of the region.
+ */
+class WorldRegion
+{
+public:
+    WorldRegion(int32 RX, int32 RY) : X(RX), Y(RY), Map(), Bytes(0) {}
+    ~WorldRegion() { UMapBuilderLib::ClearMap(Map); }
+    
+    int32 X, Y;         // Region coordinates.
+    IRect Bounds;       // Tiles covered, Bounds.Right() and Bounds.Bottom() excluded.
+    MapInfoType Map;
+    size_t Bytes;       // Estimated memory held by Map.
+};
+
+/**
+ * An unbounded world made of Width x Height regions, each one a separate run
+ * of UMapBuilderLib::GenerateMap.
+ *
+ * A region's seed is a hash of the world seed and its coordinates, so it comes
+ * out the same whenever and in whatever order it is generated. Every edge
+ * shared by two regions has a connector cell on each side, placed from a hash
+ * of the edge, which both regions join to their nearest room, stitching the
+ * regions together without either needing the other.
+ *
+ * Generated regions are kept in a least recently used cache that evicts down
+ * to a memory budget. A background thread generates the regions around the
+ * focus point, nearest first, so moving through the world rarely waits.
+ * Regions are handed out as shared pointers and stay valid after eviction.
+ */
+class MapWorld
+{
+public:
+    MapWorld(int32 WorldSeed, const GenerationParams& RegionParams, size_t MemoryBudget, int32 PrefetchRadius = 1);
+    ~MapWorld();
+    
+    /** Seed of region (rx, ry). **/
+    static int32 RegionSeed(int32 WorldSeed, int32 rx, int32 ry);
+    
+    /** Region holding world tile (x, y). **/
+    IPoint RegionOf(int32 x, int32 y) const;
+    
+    /** Cell, in world tiles, where region (rx, ry) meets its neighbour on Side, TopWall..LeftWall. **/
+    IPoint Connector(int32 rx, int32 ry, int32 Side) const;
+    
+    /** Region (rx, ry), generated now if it is not in the cache. **/
+    std::shared_ptr<const WorldRegion> Region(int32 rx, int32 ry);
+    
+    /** Region (rx, ry) if it is in the cache, otherwise null. Never waits on generation. **/
+    std::shared_ptr<const WorldRegion> FindRegion(int32 rx, int32 ry);
+    
+    /** Move the focus to world tile (x, y), the background thread fills in the regions around it. **/
+    void SetFocus(int32 x, int32 y);
+    
+    /** Block until every region around the focus is cached. **/
+    void WaitForPrefetch();
+    
+    int32 CachedRegions();
+    size_t MemoryUsed();
+    
+private:
+    typedef struct
+    {
+        std::shared_ptr<const WorldRegion> Region;
+        std::list<uint64_t>::iterator Use;
+    } CacheEntry;
+    
+    int32 seed;
+    GenerationParams params;
+    size_t budget;
+    int32 radius;
+    
+    std::mutex lock;                    // Guards everything below.
+    std::condition_variable wake;
+    std::unordered_map<uint64_t, CacheEntry> cache;
+    std::list<uint64_t> uses;           // Most recently used first.
+    size_t used;
+    IPoint focus;
+    bool focusChanged;
+    bool busy;
+    bool stop;
+    std::thread worker;
+    
+    static uint64_t Key(int32 rx, int32 ry) { return ((uint64_t)(uint32_t)rx << 32) | (uint32_t)ry; }
+    
+    std::shared_ptr<const WorldRegion> Generate(int32 rx, int32 ry) const;
+    std::shared_ptr<const WorldRegion> Insert(const std::shared_ptr<const WorldRegion>& Region);
+    void Prefetch();
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "Helper.h"
+
+namespace Parallel
+{
+    /** Number of worker threads to use, always at least one. **/
+    static int32 ThreadCount()
+    {
+        int32 n = (int32)std::thread::hardware_concurrency();
+        return (n > 0) ? n : 1;
+    }
+
+    /**
+     * Split the range [Begin, End) into one contiguous block per thread and call
+     * fn(blockBegin, blockEnd, threadIndex) for each block. Blocks are assigned in
+     * order, so block t always covers lower indices than block t+1.
+     * Returns once every block has completed.
+     */
+    template<typename Fn>
+    void For(int32 Begin, int32 End, Fn fn, int32 Threads = 0)
+    {
+        int32 count = End - Begin;
+        if(count <= 0) return;
+
+        if(Threads <= 0) Threads = ThreadCount();
+        if(Threads > count) Threads = count;
+
+        if(Threads == 1)
+        {
+            fn(Begin, End, 0);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(Threads - 1);
+
+        int32 block = count / Threads;
+        int32 extra = count % Threads;
+        int32 start = Begin;
+        for(int32 t = 0; t < Threads; t++)
+        {
+            int32 end = start + block + ((t < extra) ? 1 : 0);
+            if(t == Threads - 1)
+            {
+                // Run the last block on the calling thread.
+                fn(start, end, t);
+            }
+            else
+            {
+                workers.push_back(std::thread(fn, start, end, t));
+            }
+            start = end;
+        }
+
+        for(std::thread& w : workers)
+        {
+            w.join();
+        }
+    }
+}
\ No newline at end of file
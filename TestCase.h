@@ -1,9 +1,27 @@
-#pragma once
-
-class TestCase
-{
-public:
-    static void Run();
-    static void RunPointTests();
-    static void RunRectTests();
+#pragma once
+
+class TestCase
+{
+public:
+    static void Run();
+    static void RunPointTests();
+    static void RunRectTests();
+    static void RunUnionFindTests();
+    static void RunMinSpanTests();
+    static void RunRandomEdgeTests();
+    static void RunCorridorRouterTests();
+    static void RunCorridorEndpointTests();
+    static void RunDoorTests();
+    static void RunTileGridTests();
+    static void RunWorldTests();
+    static void RunMapFileTests();
+    static void RunTileCodecTests();
+    static void RunExportTests();
+    static void RunMapCacheTests();
+    static void RunRasterTests();
+    static void RunDistanceFieldTests();
+    static void RunValidatorTests();
+    static void RunVertexTests();
+    static void RunTripleBufferTests();
+    static void RunRandomTests();
 };
\ No newline at end of file
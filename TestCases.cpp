@@ -1,431 +1,2779 @@
-#include "TestCase.h"
-#include "IPoint.h"
-#include "IRect.h"
-#include "Helper.h"
-#include <iostream>
-
-void TestCase::Run()
-{
-    std::cout << "Running Point Test Cases:\n";
-    TestCase::RunPointTests();
-    
-    std::cout << "Running Rectangle Test Cases:\n";
-    TestCase::RunRectTests();
-}
-
-void TestCase::RunPointTests()
-{
-    int count = 0;
-    int pass = 0;
-    
-    IPoint p1(10,5);
-    IPoint p2(p1);
-    
-    // Copy Constructor
-    count++;
-    std::cout << "Copy Constructor: ";
-    if(p2.X == p1.X && p2.Y == p1.Y)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p2.toString() << "\n";
-    }
-    
-    IPoint p3(35, 25);
-    p2 = p3;
-    
-    // Assignment operator
-    count++;
-    std::cout << "Assignment operator: ";
-    if(p2.X == p3.X && p2.Y == p3.Y)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p2.toString() << "\n";
-    }
-    
-    // Addition and Subtraction
-    IPoint p4;
-    p4 = p1 + p2;
-    count++;
-    std::cout << "Addition operator: ";
-    if(p4.X == 45 && p4.Y == 30)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p4.toString() << "\n";
-    }
-    
-    p4 = p2 - p1;
-    count++;
-    std::cout << "Subtraction operator: ";
-    if(p4.X == 25 && p4.Y == 20)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p4.toString() << "\n";
-    }
-    
-    // Multiplation and Divide
-    p4 = p1 * 5;
-    count++;
-    std::cout << "Multiplation operator: ";
-    if(p4.X == 50 && p4.Y == 25)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p4.toString() << "\n";
-    }
-    
-    p4 = p2 / 5;
-    count++;
-    std::cout << "Divide operator: ";
-    if(p4.X == 7 && p4.Y == 5)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p4.toString() << "\n";
-    }
-    
-    // Zero and IsNull
-    count++;
-    std::cout << "!IsNull: ";
-    if(p2.IsNull() == false)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p2.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Zero().IsNull: ";
-    if(p2.Zero().IsNull() == true)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << p2.toString() << "\n";
-    }
-    
-    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
-}
-
-void TestCase::RunRectTests()
-{
-    int count = 0;
-    int pass = 0;
-    
-    IRect r1;
-    
-    // IsNull
-    count++;
-    std::cout << "IsNull: ";
-    if(r1.IsNull() == true)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r1.toString() << "\n";
-    }
-    
-    IRect r2(10, 20, 40, 40);
-    
-    IRect r3(r2);
-    
-    // Copy Constructor
-    count++;
-    std::cout << "Copy Constructor: ";
-    if((r3.Position.X == r2.Position.X) && (r3.Position.Y == r2.Position.Y)
-       && (r3.Width == r2.Width) && (r3.Height == r2.Height))
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r3.toString() << "\n";
-    }
-    
-    r1 = r3;
-    
-    // Assignment operator
-    count++;
-    std::cout << "Assignment operator: ";
-    if((r1.Position.X == r3.Position.X) && (r1.Position.Y == r3.Position.Y)
-       && (r1.Width == r3.Width) && (r1.Height == r3.Height))
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r1.toString() << "\n";
-    }
-    
-    r2.Position.X = 30;
-    r2.Position.Y = 40;
-    r2.Height = 60;
-    
-    r3.Position.X = 20;
-    r3.Position.Y = 65;
-    r3.Width = 20;
-    r3.Height = 20;
-    
-    // Positional tests
-    count++;
-    std::cout << "Half Width: ";
-    if(r2.HalfWidth() == 20)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r2.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Half Height: ";
-    if(r2.HalfHeight() == 30)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r2.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "CenterX: ";
-    if(r2.CenterX() == 50)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r2.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "CenterY: ";
-    if(r2.CenterY() == 70)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r2.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Left: ";
-    if(r3.Left() == 20)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r3.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Right: ";
-    if(r3.Right() == 40)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r3.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Top: ";
-    if(r3.Top() == 65)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r3.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Bottom: ";
-    if(r3.Bottom() == 85)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r3.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Contains: ";
-    if(r1.Contains(20, 30))
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r1.toString() << "\n";
-    }
-    
-    IPoint p(60, 50);
-    
-    count++;
-    std::cout << "!Contains: ";
-    if(r1.Contains(p) == false)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r1.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "IsIntersecting: ";
-    if(r1.IsIntersecting(r2) && r2.IsIntersecting(r1))
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r1.toString() << "<>" << r2.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "!IsIntersecting: ";
-    if(r1.IsIntersecting(r3) == false && r3.IsIntersecting(r1) == false)
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r1.toString() << "<>" << r3.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "Intersect: ";
-    IRect* r4 = r2.Intersect(r1);
-    if(r4)
-    {
-        if((r4->Position.X == 30) && (r4->Position.Y == 40)
-           && (r4->Width == 20) && (r4->Height == 20))
-        {
-            pass++;
-            std::cout << "PASS\n";
-        }
-        else
-        {
-            std::cout << "FAIL - " << r4->toString() << "\n";
-        }
-    }
-    else
-    {
-        std::cout << "FAIL - Intersect returned NULL\n";
-    }
-    
-    delete r4;
-    
-    count++;
-    std::cout << "IntersectWith: ";
-    r3.IntersectWith(r2);
-    if((r3.Position.X == 30) && (r3.Position.Y == 65)
-       && (r3.Width == 10) && (r3.Height == 20))
-    {
-        pass++;
-        std::cout << "PASS\n";
-    }
-    else
-    {
-        std::cout << "FAIL - " << r3.toString() << "\n";
-    }
-    
-    count++;
-    std::cout << "United: ";
-    r4 = r1.United(r2);
-    if(r4)
-    {
-        if((r4->Position.X == 10) && (r4->Position.Y == 20)
-           && (r4->Width == 60) && (r4->Height == 80))
-        {
-            pass++;
-            std::cout << "PASS\n";
-        }
-        else
-        {
-            std::cout << "FAIL - " << r4->toString() << "\n";
-        }
-    }
-    else
-    {
-        std::cout << "FAIL - United returned NULL\n";
-    }
-    
-    delete r4;
-    
-    count++;
-    std::cout << "Penetration: ";
-    IPoint* penetration = r1.Penetration(r2);
-    if(penetration)
-    {
-        if((penetration->X == -20) && (penetration->Y == -20))
-        {
-            pass++;
-            std::cout << "PASS\n";
-        }
-        else
-        {
-            std::cout << "FAIL - " << p.toString() << "\n";
-        }
-    }
-    else 
-    {
-        std::cout << "FAIL - penetration returned NULL\n";
-    }
-    
-    delete penetration;
-    
-    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
-}
-
-    
\ No newline at end of file
+#include "TestCase.h"
+#include "IPoint.h"
+#include "IRect.h"
+#include "Helper.h"
+#include "Delaunay.h"
+#include "Kruskal.h"
+#include "Boruvka.h"
+#include "UnionFind.h"
+#include "DynamicMinSpan.h"
+#include "WeightedSampler.h"
+#include "CorridorRouter.h"
+#include "CorridorEndpoints.h"
+#include "MapBuilderLib.h"
+#include "BVH.h"
+#include "TileGrid.h"
+#include "TileChunks.h"
+#include "MapWorld.h"
+#include "MapFile.h"
+#include "TileCodec.h"
+#include "MapExport.h"
+#include "MapCache.h"
+#include "MapRaster.h"
+#include "DistanceField.h"
+#include "MapValidator.h"
+#include "MapVertices.h"
+#include "TripleBuffer.h"
+#include "CounterRand.h"
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <set>
+#include <thread>
+
+void TestCase::Run()
+{
+    std::cout << "Running Point Test Cases:\n";
+    TestCase::RunPointTests();
+    
+    std::cout << "Running Rectangle Test Cases:\n";
+    TestCase::RunRectTests();
+    
+    std::cout << "Running Union Find Test Cases:\n";
+    TestCase::RunUnionFindTests();
+    
+    std::cout << "Running Minimum Span Test Cases:\n";
+    TestCase::RunMinSpanTests();
+    
+    std::cout << "Running Random Edge Test Cases:\n";
+    TestCase::RunRandomEdgeTests();
+    
+    std::cout << "Running Corridor Router Test Cases:\n";
+    TestCase::RunCorridorRouterTests();
+    
+    std::cout << "Running Corridor Endpoint Test Cases:\n";
+    TestCase::RunCorridorEndpointTests();
+    
+    std::cout << "Running Door Test Cases:\n";
+    TestCase::RunDoorTests();
+    
+    std::cout << "Running Tile Grid Test Cases:\n";
+    TestCase::RunTileGridTests();
+    
+    std::cout << "Running World Test Cases:\n";
+    TestCase::RunWorldTests();
+    
+    std::cout << "Running Map File Test Cases:\n";
+    TestCase::RunMapFileTests();
+    
+    std::cout << "Running Tile Codec Test Cases:\n";
+    TestCase::RunTileCodecTests();
+    
+    std::cout << "Running Export Test Cases:\n";
+    TestCase::RunExportTests();
+    
+    std::cout << "Running Map Cache Test Cases:\n";
+    TestCase::RunMapCacheTests();
+    
+    std::cout << "Running Raster Test Cases:\n";
+    TestCase::RunRasterTests();
+    
+    std::cout << "Running Distance Field Test Cases:\n";
+    TestCase::RunDistanceFieldTests();
+    
+    std::cout << "Running Validator Test Cases:\n";
+    TestCase::RunValidatorTests();
+    
+    std::cout << "Running Vertex Test Cases:\n";
+    TestCase::RunVertexTests();
+    
+    std::cout << "Running Triple Buffer Test Cases:\n";
+    TestCase::RunTripleBufferTests();
+    
+    std::cout << "Running Random Test Cases:\n";
+    TestCase::RunRandomTests();
+}
+
+void TestCase::RunPointTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    IPoint p1(10,5);
+    IPoint p2(p1);
+    
+    // Copy Constructor
+    count++;
+    std::cout << "Copy Constructor: ";
+    if(p2.X == p1.X && p2.Y == p1.Y)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p2.toString() << "\n";
+    }
+    
+    IPoint p3(35, 25);
+    p2 = p3;
+    
+    // Assignment operator
+    count++;
+    std::cout << "Assignment operator: ";
+    if(p2.X == p3.X && p2.Y == p3.Y)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p2.toString() << "\n";
+    }
+    
+    // Addition and Subtraction
+    IPoint p4;
+    p4 = p1 + p2;
+    count++;
+    std::cout << "Addition operator: ";
+    if(p4.X == 45 && p4.Y == 30)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p4.toString() << "\n";
+    }
+    
+    p4 = p2 - p1;
+    count++;
+    std::cout << "Subtraction operator: ";
+    if(p4.X == 25 && p4.Y == 20)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p4.toString() << "\n";
+    }
+    
+    // Multiplation and Divide
+    p4 = p1 * 5;
+    count++;
+    std::cout << "Multiplation operator: ";
+    if(p4.X == 50 && p4.Y == 25)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p4.toString() << "\n";
+    }
+    
+    p4 = p2 / 5;
+    count++;
+    std::cout << "Divide operator: ";
+    if(p4.X == 7 && p4.Y == 5)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p4.toString() << "\n";
+    }
+    
+    // Zero and IsNull
+    count++;
+    std::cout << "!IsNull: ";
+    if(p2.IsNull() == false)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p2.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Zero().IsNull: ";
+    if(p2.Zero().IsNull() == true)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << p2.toString() << "\n";
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunRectTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    IRect r1;
+    
+    // IsNull
+    count++;
+    std::cout << "IsNull: ";
+    if(r1.IsNull() == true)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r1.toString() << "\n";
+    }
+    
+    IRect r2(10, 20, 40, 40);
+    
+    IRect r3(r2);
+    
+    // Copy Constructor
+    count++;
+    std::cout << "Copy Constructor: ";
+    if((r3.Position.X == r2.Position.X) && (r3.Position.Y == r2.Position.Y)
+       && (r3.Width == r2.Width) && (r3.Height == r2.Height))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r3.toString() << "\n";
+    }
+    
+    r1 = r3;
+    
+    // Assignment operator
+    count++;
+    std::cout << "Assignment operator: ";
+    if((r1.Position.X == r3.Position.X) && (r1.Position.Y == r3.Position.Y)
+       && (r1.Width == r3.Width) && (r1.Height == r3.Height))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r1.toString() << "\n";
+    }
+    
+    r2.Position.X = 30;
+    r2.Position.Y = 40;
+    r2.Height = 60;
+    
+    r3.Position.X = 20;
+    r3.Position.Y = 65;
+    r3.Width = 20;
+    r3.Height = 20;
+    
+    // Positional tests
+    count++;
+    std::cout << "Half Width: ";
+    if(r2.HalfWidth() == 20)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r2.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Half Height: ";
+    if(r2.HalfHeight() == 30)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r2.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "CenterX: ";
+    if(r2.CenterX() == 50)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r2.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "CenterY: ";
+    if(r2.CenterY() == 70)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r2.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Left: ";
+    if(r3.Left() == 20)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r3.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Right: ";
+    if(r3.Right() == 40)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r3.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Top: ";
+    if(r3.Top() == 65)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r3.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Bottom: ";
+    if(r3.Bottom() == 85)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r3.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Contains: ";
+    if(r1.Contains(20, 30))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r1.toString() << "\n";
+    }
+    
+    IPoint p(60, 50);
+    
+    count++;
+    std::cout << "!Contains: ";
+    if(r1.Contains(p) == false)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r1.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "IsIntersecting: ";
+    if(r1.IsIntersecting(r2) && r2.IsIntersecting(r1))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r1.toString() << "<>" << r2.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "!IsIntersecting: ";
+    if(r1.IsIntersecting(r3) == false && r3.IsIntersecting(r1) == false)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r1.toString() << "<>" << r3.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "Intersect: ";
+    IRect* r4 = r2.Intersect(r1);
+    if(r4)
+    {
+        if((r4->Position.X == 30) && (r4->Position.Y == 40)
+           && (r4->Width == 20) && (r4->Height == 20))
+        {
+            pass++;
+            std::cout << "PASS\n";
+        }
+        else
+        {
+            std::cout << "FAIL - " << r4->toString() << "\n";
+        }
+    }
+    else
+    {
+        std::cout << "FAIL - Intersect returned NULL\n";
+    }
+    
+    delete r4;
+    
+    count++;
+    std::cout << "IntersectWith: ";
+    r3.IntersectWith(r2);
+    if((r3.Position.X == 30) && (r3.Position.Y == 65)
+       && (r3.Width == 10) && (r3.Height == 20))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << r3.toString() << "\n";
+    }
+    
+    count++;
+    std::cout << "United: ";
+    r4 = r1.United(r2);
+    if(r4)
+    {
+        if((r4->Position.X == 10) && (r4->Position.Y == 20)
+           && (r4->Width == 60) && (r4->Height == 80))
+        {
+            pass++;
+            std::cout << "PASS\n";
+        }
+        else
+        {
+            std::cout << "FAIL - " << r4->toString() << "\n";
+        }
+    }
+    else
+    {
+        std::cout << "FAIL - United returned NULL\n";
+    }
+    
+    delete r4;
+    
+    count++;
+    std::cout << "Penetration: ";
+    IPoint* penetration = r1.Penetration(r2);
+    if(penetration)
+    {
+        if((penetration->X == -20) && (penetration->Y == -20))
+        {
+            pass++;
+            std::cout << "PASS\n";
+        }
+        else
+        {
+            std::cout << "FAIL - " << p.toString() << "\n";
+        }
+    }
+    else 
+    {
+        std::cout << "FAIL - penetration returned NULL\n";
+    }
+    
+    delete penetration;
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+    
+
+void TestCase::RunUnionFindTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    SmallUnionFind uf(8);
+    uf.link(0, 1);
+    uf.link(2, 3);
+    uf.link(0, 2);
+    
+    // Union by size
+    count++;
+    std::cout << "Set size: ";
+    if(uf.size(3) == 4 && uf.size(4) == 1 && uf.count() == 5)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - size " << uf.size(3) << " count " << uf.count() << "\n";
+    }
+    
+    int32 mark = uf.checkpoint();
+    uf.link(4, 5);
+    uf.link(5, 1);
+    
+    count++;
+    std::cout << "Link after checkpoint: ";
+    if(uf.connected(4, 3) && uf.count() == 3)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - count " << uf.count() << "\n";
+    }
+    
+    // Rollback
+    uf.rollback(mark);
+    count++;
+    std::cout << "Rollback: ";
+    if(!uf.connected(4, 3) && !uf.connected(4, 5) && uf.connected(0, 3) && uf.size(0) == 4 && uf.count() == 5)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - count " << uf.count() << "\n";
+    }
+    
+    uf.commit();
+    uf.link(6, 7);
+    uf.rollback(0);
+    count++;
+    std::cout << "Commit: ";
+    if(uf.connected(6, 7) && uf.count() == 4)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - count " << uf.count() << "\n";
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunMinSpanTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    Triangulation tri(300);
+    tri.randomPoints(800, 800, 1);
+    QuadraticAlgorithm qa;
+    qa.triangulate(tri);
+    
+    std::vector<Edge*> kruskalEdges = tri.edge;
+    std::vector<Edge*> boruvkaEdges = tri.edge;
+    std::list<int32>* kruskal = Kruskal::runKruskal(tri.point, kruskalEdges);
+    std::list<int32>* boruvka = Boruvka::runBoruvka(tri.point, boruvkaEdges, 4);
+    
+    // Same tree in the same order
+    count++;
+    std::cout << "Boruvka matches Kruskal: ";
+    if(*kruskal == *boruvka)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << (kruskal->size() / 2) << " vs " << (boruvka->size() / 2) << " edges\n";
+    }
+    
+    // Spanning tree of a connected graph has V-1 edges
+    count++;
+    std::cout << "Spanning edge count: ";
+    if(boruvka->size() / 2 == (size_t)(tri.nPoints - 1))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << (boruvka->size() / 2) << "\n";
+    }
+    
+    // Both remove the same edges from the edge list
+    count++;
+    std::cout << "Remaining edges match: ";
+    if(kruskalEdges == boruvkaEdges && kruskalEdges.size() + (kruskal->size() / 2) == tri.edge.size())
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << kruskalEdges.size() << " vs " << boruvkaEdges.size() << "\n";
+    }
+    
+    // Removing edges keeps the tree equal to a fresh Kruskal run on what is left
+    std::vector<Edge*> allEdges(tri.edge.begin(), tri.edge.begin() + tri.nEdges);
+    DynamicMinSpan span(tri.point, allEdges);
+    std::list<int32> replacements;
+    for(int32 i = 0; i < 60; i++)
+    {
+        Edge* e = allEdges[(i * 7) % allEdges.size()];
+        span.RemoveEdge(e->s, e->t, &replacements);
+        allEdges.erase(allEdges.begin() + (i * 7) % allEdges.size());
+    }
+    span.RemoveVertex(5, &replacements);
+    for(int32 i = allEdges.size() - 1; i >= 0; i--)
+    {
+        if(allEdges[i]->s == 5 || allEdges[i]->t == 5) allEdges.erase(allEdges.begin() + i);
+    }
+    
+    std::list<int32>* rebuilt = Kruskal::runKruskal(tri.point, allEdges);
+    std::list<int32> dynamic;
+    span.GetMinSpan(dynamic);
+    
+    count++;
+    std::cout << "Dynamic span after removals: ";
+    if(dynamic == *rebuilt && !span.Connected(5, 6))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << (dynamic.size() / 2) << " vs " << (rebuilt->size() / 2) << " edges\n";
+    }
+    
+    delete kruskal;
+    delete boruvka;
+    delete rebuilt;
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Whether the edges AddRandomEdges put after the Tree spanning tree edges of Edges are all distinct
+// triangulation edges left out of the tree, Added set to how many there were.
+static bool validRandomEdges(const std::list<int32>& Edges, int32 Tree, const Triangulation& Tri, int32& Added)
+{
+    std::set<std::pair<int32, int32> > pool;
+    for(Edge* e : Tri.edge)
+    {
+        if(e->s != e->t) pool.insert(std::make_pair(std::min(e->s, e->t), std::max(e->s, e->t)));
+    }
+    
+    std::set<std::pair<int32, int32> > seen;
+    std::list<int32>::const_iterator itr = Edges.begin();
+    for(int32 i = 0; i < Tree; i++)
+    {
+        int32 s = *(itr++);
+        int32 t = *(itr++);
+        seen.insert(std::make_pair(std::min(s, t), std::max(s, t)));
+    }
+    
+    Added = 0;
+    while(itr != Edges.end())
+    {
+        int32 s = *(itr++);
+        int32 t = *(itr++);
+        std::pair<int32, int32> key(std::min(s, t), std::max(s, t));
+        if(s == t || pool.count(key) == 0 || !seen.insert(key).second) return false;
+        Added++;
+    }
+    return true;
+}
+
+void TestCase::RunRandomEdgeTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Every item with a weight is drawn exactly once, in any order, and zero weights never are
+    bool drawn = true;
+    CounterRand rng(11, RandomEdgeStream);
+    for(int32 trial = 0; drawn && trial < 200; trial++)
+    {
+        int32 n = 1 + (int32)rng.Below(40);
+        std::vector<double> weights(n);
+        int32 live = 0;
+        for(int32 i = 0; i < n; i++)
+        {
+            weights[i] = (rng.Below(3) == 0) ? 0.0 : rng.NextDouble() * 10.0;
+            if(weights[i] > 0.0) live++;
+        }
+        
+        WeightedSampler sampler(weights);
+        std::vector<bool> taken(n, false);
+        
+        // Take one item out by hand first, it must not be drawn afterwards.
+        int32 removed = (int32)rng.Below(n);
+        if(weights[removed] > 0.0) live--;
+        sampler.remove(removed);
+        taken[removed] = true;
+        
+        drawn = (sampler.count() == live);
+        for(int32 i = 0; drawn && i < live; i++)
+        {
+            // Draw at the very ends of [0, 1) now and then as well as in between.
+            double u = (i % 7 == 0) ? 0.0 : (i % 7 == 1) ? 0.9999999999 : rng.NextDouble();
+            int32 index = sampler.draw(u);
+            drawn = (index >= 0 && index < n && !taken[index] && weights[index] > 0.0);
+            if(drawn) taken[index] = true;
+        }
+        drawn = drawn && sampler.count() == 0 && sampler.draw(rng.NextDouble()) == -1;
+    }
+    
+    // A weight three times as large is drawn first about three times as often
+    int32 heavy = 0;
+    for(int32 i = 0; i < 4000; i++)
+    {
+        std::vector<double> weights(2);
+        weights[0] = 1.0;
+        weights[1] = 3.0;
+        WeightedSampler sampler(weights);
+        if(sampler.draw(rng.NextDouble()) == 1) heavy++;
+    }
+    
+    count++;
+    std::cout << "Weighted sampler draws: ";
+    if(drawn && heavy > 2800 && heavy < 3200)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << heavy << " of 4000 heavy\n";
+    }
+    
+    Triangulation tri(200);
+    tri.randomPoints(600, 600, 3);
+    QuadraticAlgorithm qa;
+    qa.triangulate(tri);
+    
+    MapInfoType info = {};
+    info.Seed = 5;
+    std::list<int32>* tree = UMapBuilderLib::CalcMinSpan(info, tri);
+    int32 treeEdges = info.MinConnectedCorridors / 2;
+    int32 spare = 0;
+    for(Edge* e : tri.edge)
+    {
+        if(e->s != e->t) spare++;
+    }
+    
+    // Asking for more corridors than there are edges outside the tree adds each of them once
+    info.MaxRandomCorridors = spare * 2 + 10;
+    std::list<int32> all = *tree;
+    UMapBuilderLib::AddRandomEdges(info, tri, all);
+    int32 added = 0;
+    
+    count++;
+    std::cout << "More corridors than edges: ";
+    if(validRandomEdges(all, treeEdges, tri, added) && added == spare)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << added << " of " << spare << " edges\n";
+    }
+    
+    // Every weighting picks the asked for number of distinct edges from outside the tree
+    bool modes = true;
+    CorridorWeighting weightings[3] = { UniformWeighting, ShortEdgeWeighting, LongLoopWeighting };
+    info.MaxRandomCorridors = spare / 3;
+    for(int32 w = 0; modes && w < 3; w++)
+    {
+        std::list<int32> some = *tree;
+        UMapBuilderLib::AddRandomEdges(info, tri, some, weightings[w]);
+        modes = validRandomEdges(some, treeEdges, tri, added) && added == info.MaxRandomCorridors;
+    }
+    
+    count++;
+    std::cout << "Weighting modes: ";
+    if(modes)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << added << " of " << info.MaxRandomCorridors << " edges\n";
+    }
+    
+    delete tree;
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Length of an axis aligned route, or -1 if it steps onto a blocked cell between its ends.
+static int32 routeLength(const std::vector<IPoint>& Path, const BitGrid& Blocked)
+{
+    int32 length = 0;
+    for(size_t i = 1; i < Path.size(); i++)
+    {
+        IPoint a = Path[i - 1];
+        IPoint b = Path[i];
+        if(a.X != b.X && a.Y != b.Y) return -1;
+        
+        int32 dx = (b.X > a.X) - (b.X < a.X);
+        int32 dy = (b.Y > a.Y) - (b.Y < a.Y);
+        while(a.X != b.X || a.Y != b.Y)
+        {
+            a.X += dx;
+            a.Y += dy;
+            length++;
+            if(i + 1 < Path.size() || a.X != b.X || a.Y != b.Y)
+            {
+                if(Blocked.Get(a.X, a.Y)) return -1;
+            }
+        }
+    }
+    return length;
+}
+
+void TestCase::RunCorridorRouterTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // A single room sits between the two ends, going round it takes 11 + 40 + 11 steps.
+    MapInfoType info;
+    info.Width = 60;
+    info.Height = 30;
+    info.Rooms.push_back(new Room(20, 5, 20, 20));
+    
+    CorridorRouter router(info);
+    RouteWorkspace work;
+    IPoint start(10, 15);
+    IPoint end(50, 15);
+    
+    std::vector<IPoint> astar;
+    router.Route(start, end, astar, work);
+    int32 astarExpansions = work.Expansions;
+    
+    count++;
+    std::cout << "A* routes around room: ";
+    if(astar.size() >= 2 && routeLength(astar, router.Blocked()) > 0 &&
+       astar.front().X == start.X && astar.front().Y == start.Y && astar.back().X == end.X && astar.back().Y == end.Y)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << astar.size() << " points\n";
+    }
+    
+    // Turn costs keep it to two corners
+    count++;
+    std::cout << "A* route turns twice: ";
+    if(astar.size() == 4)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << astar.size() << " points\n";
+    }
+    
+    std::vector<IPoint> jump;
+    router.RouteJumpPoint(start, end, jump, work);
+    
+    count++;
+    std::cout << "Jump point route is shortest: ";
+    if(routeLength(jump, router.Blocked()) == 62)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << routeLength(jump, router.Blocked()) << "\n";
+    }
+    
+    count++;
+    std::cout << "Jump point expands fewer nodes: ";
+    if(work.Expansions < astarExpansions)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << work.Expansions << " vs " << astarExpansions << "\n";
+    }
+    
+    deleteContainerContents(info.Rooms);
+    
+    // Routing on one thread or several gives the same corridors in the same order
+    MapInfoType maps[2];
+    std::list<int32> edges;
+    for(int32 m = 0; m < 2; m++)
+    {
+        maps[m].Width = 200;
+        maps[m].Height = 200;
+        for(int32 i = 0; i < 25; i++)
+        {
+            maps[m].Rooms.push_back(new Room((i % 5) * 40 + (i * 7) % 13, (i / 5) * 40 + (i * 11) % 17, 12, 10));
+        }
+    }
+    for(int32 i = 0; i < 25; i++)
+    {
+        // Neighbours to the right, below and diagonally below
+        int32 links[3] = { (i % 5 < 4) ? i + 1 : -1, (i < 20) ? i + 5 : -1, (i % 5 < 4 && i < 20) ? i + 6 : -1 };
+        for(int32 link : links)
+        {
+            if(link != -1)
+            {
+                edges.push_back(i);
+                edges.push_back(link);
+            }
+        }
+    }
+    UMapBuilderLib::GenerateCorridors(maps[0], edges, AStarRouting, 1);
+    UMapBuilderLib::GenerateCorridors(maps[1], edges, AStarRouting, 3);
+    
+    bool same = (maps[0].Corridors.size() == maps[1].Corridors.size());
+    for(size_t i = 0; same && i < maps[0].Corridors.size(); i++)
+    {
+        const std::vector<IPoint>& a = maps[0].Corridors[i]->Path;
+        const std::vector<IPoint>& b = maps[1].Corridors[i]->Path;
+        same = (a.size() == b.size());
+        for(size_t j = 0; same && j < a.size(); j++)
+        {
+            same = (a[j].X == b[j].X && a[j].Y == b[j].Y);
+        }
+    }
+    
+    count++;
+    std::cout << "Same corridors for any thread count: ";
+    if(same && maps[0].Corridors.size() == edges.size() / 2)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << maps[0].Corridors.size() << " vs " << maps[1].Corridors.size() << " corridors\n";
+    }
+    
+    for(int32 m = 0; m < 2; m++)
+    {
+        deleteContainerContents(maps[m].Rooms);
+        deleteContainerContents(maps[m].Corridors);
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Where a corridor leaves room towards other, worked out with angles the way the map builder did before CorridorEndpoints.
+static void trigEndpoint(const IRect& room, const IRect& other, int32& X, int32& Y)
+{
+    int32 hw = room.HalfWidth();
+    int32 hh = room.HalfHeight();
+    double lu = atan2(hh, hw);
+    double ru = atan2(hh, -hw);
+    double rd = atan2(-hh, -hw);
+    double ld = atan2(-hh, hw);
+    double ang = atan2(room.CenterY() - other.CenterY(), room.CenterX() - other.CenterX());
+    
+    X = -1;
+    Y = -1;
+    if(ang >= ru || ang <= rd)
+    {
+        X = room.Right();
+        Y = (int32)round(room.CenterY() + (hw * tan(ang)));
+    }
+    else if(ang <= lu && ang >= ld)
+    {
+        X = room.Left();
+        Y = (int32)round(room.CenterY() - (hw * tan(ang)));
+    }
+    else if(ang > lu && ang < ru)
+    {
+        X = (int32)round(room.CenterX() + (hh * tan(ang + (M_PI / 2))));
+        Y = room.Top();
+    }
+    else if(ang < ld && ang > rd)
+    {
+        X = (int32)round(room.CenterX() - (hh * tan(ang + (M_PI / 2))));
+        Y = room.Bottom();
+    }
+}
+
+// Whether entry i of Ends lands exactly half way between two tiles along the side it leaves through.
+static bool endpointTie(const CorridorEndpoints& Ends, int32 i)
+{
+    int64_t ax = std::abs(Ends.DX[i]);
+    int64_t ay = std::abs(Ends.DY[i]);
+    bool side = ay * Ends.HW[i] <= ax * Ends.HH[i];
+    int64_t num = side ? (int64_t)Ends.HW[i] * Ends.DY[i] : (int64_t)Ends.HH[i] * Ends.DX[i];
+    int64_t den = side ? ax : ay;
+    return den != 0 && (num * 2) % den == 0 && num % den != 0;
+}
+
+void TestCase::RunCorridorEndpointTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Random room pairs give the trigonometric result, bar ties at .5 where tan's rounding picked either tile
+    const int32 pairs = 200000;
+    CounterRand rng(7, RoomStream);
+    std::vector<IRect> rooms(pairs * 2);
+    CorridorEndpoints ends(pairs);
+    for(int32 i = 0; i < pairs; i++)
+    {
+        rooms[i * 2] = IRect(rng.Range(0, 300), rng.Range(0, 300), rng.Range(2, 40), rng.Range(2, 40));
+        rooms[i * 2 + 1] = IRect(rng.Range(0, 300), rng.Range(0, 300), rng.Range(2, 40), rng.Range(2, 40));
+        ends.Set(i, rooms[i * 2], rooms[i * 2 + 1]);
+    }
+    ends.Solve();
+    
+    int32 ties = 0;
+    int32 wrong = 0;
+    for(int32 i = 0; i < pairs; i++)
+    {
+        int32 x, y;
+        trigEndpoint(rooms[i * 2], rooms[i * 2 + 1], x, y);
+        if(x == ends.OutX[i] && y == ends.OutY[i]) continue;
+        
+        // A tie may only move the end one tile along the side it leaves through.
+        if(endpointTie(ends, i) && std::abs(x - ends.OutX[i]) + std::abs(y - ends.OutY[i]) == 1)
+        {
+            ties++;
+        }
+        else
+        {
+            wrong++;
+        }
+    }
+    
+    count++;
+    std::cout << "Matches trigonometric endpoints: ";
+    if(wrong == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << wrong << " differ, " << ties << " ties\n";
+    }
+    
+    // Coincident centres, straight up, down and across, and rays through a corner exactly
+    std::vector<IRect> from;
+    std::vector<IRect> to;
+    for(int32 w = 2; w <= 40; w++)
+    {
+        for(int32 h = 2; h <= 40; h++)
+        {
+            IRect room(100, 100, w, h);
+            for(int32 k = -3; k <= 3; k++)
+            {
+                int32 offsets[4][2] = { { 0, k }, { k, 0 }, { k * room.HalfWidth(), k * room.HalfHeight() }, { k * room.HalfWidth(), -k * room.HalfHeight() } };
+                for(int32 o = 0; o < 4; o++)
+                {
+                    from.push_back(room);
+                    to.push_back(IRect(room.CenterX() + offsets[o][0] - 2, room.CenterY() + offsets[o][1] - 2, 4, 4));
+                }
+            }
+        }
+    }
+    
+    CorridorEndpoints edge(from.size());
+    for(int32 i = 0; i < edge.Size(); i++)
+    {
+        edge.Set(i, from[i], to[i]);
+    }
+    edge.Solve();
+    
+    wrong = 0;
+    for(int32 i = 0; i < edge.Size(); i++)
+    {
+        int32 x, y;
+        trigEndpoint(from[i], to[i], x, y);
+        if(x != edge.OutX[i] || y != edge.OutY[i]) wrong++;
+    }
+    
+    count++;
+    std::cout << "Degenerate directions: ";
+    if(wrong == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << wrong << " of " << edge.Size() << " differ\n";
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunDoorTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    std::vector<IRect> boxes;
+    for(int32 i = 0; i < 100; i++)
+    {
+        boxes.push_back(IRect((i % 10) * 20 + i % 3, (i / 10) * 20 + i % 7, 5 + i % 11, 4 + i % 5));
+    }
+    BVH bvh(boxes);
+    
+    // Queries agree with checking every box
+    bool same = true;
+    std::vector<int32> found;
+    for(int32 q = 0; same && q < 50; q++)
+    {
+        IRect area((q * 37) % 200, (q * 53) % 200, q % 40, (q * 3) % 30);
+        bvh.Query(area, found);
+        
+        std::vector<int32> expected;
+        for(int32 i = 0; i < (int32)boxes.size(); i++)
+        {
+            if(boxes[i].Left() <= area.Right() && boxes[i].Right() >= area.Left() &&
+               boxes[i].Top() <= area.Bottom() && boxes[i].Bottom() >= area.Top())
+            {
+                expected.push_back(i);
+            }
+        }
+        same = (found == expected);
+    }
+    
+    count++;
+    std::cout << "BVH query matches brute force: ";
+    if(same)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << found.size() << " boxes found\n";
+    }
+    
+    // A straight corridor between two rooms gets a door in each facing wall
+    MapInfoType info;
+    info.Width = 100;
+    info.Height = 50;
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(60, 10, 20, 20));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges);
+    UMapBuilderLib::PlaceDoors(info);
+    
+    count++;
+    std::cout << "Doors placed in facing walls: ";
+    if(info.Doors.size() == 2 &&
+       info.Doors[0]->LinkedRoom == info.Rooms[0] && info.Doors[0]->Wall == RightWall && info.Doors[0]->X == 30 &&
+       info.Doors[1]->LinkedRoom == info.Rooms[1] && info.Doors[1]->Wall == LeftWall && info.Doors[1]->X == 60 &&
+       info.Rooms[0]->Corridors.size() == 1 && info.Rooms[1]->Corridors.size() == 1)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << info.Doors.size() << " doors\n";
+    }
+    
+    // A feature on the corridor is absorbed into it, one off to the side is left alone
+    info.CorridorFeatures.push_back(new CorridorFeature(40, 16, 6, 6));
+    info.CorridorFeatures.push_back(new CorridorFeature(40, 35, 6, 6));
+    UMapBuilderLib::LinkCorridorFeatures(info);
+    Corridor* corridor = info.Corridors[0];
+    
+    count++;
+    std::cout << "Feature linked to crossing corridor: ";
+    if(info.CorridorFeatures[0]->LinkedCorridor == corridor && info.CorridorFeatures[0]->Corridors.size() == 1 &&
+       info.CorridorFeatures[1]->LinkedCorridor == 0 && info.CorridorFeatures[1]->Corridors.empty() &&
+       corridor->Features.size() == 1 && corridor->Bounds.Contains(info.CorridorFeatures[0]->Bounds))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << corridor->Features.size() << " features\n";
+    }
+    
+    deleteContainerContents(info.Rooms);
+    deleteContainerContents(info.Corridors);
+    deleteContainerContents(info.CorridorFeatures);
+    deleteContainerContents(info.Doors);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunTileGridTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Two rooms joined by a straight corridor along y = 20
+    MapInfoType info;
+    info.Width = 100;
+    info.Height = 50;
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(60, 10, 20, 20));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges);
+    UMapBuilderLib::PlaceDoors(info);
+    
+    TileGrid grid;
+    grid.Rasterise(info);
+    
+    count++;
+    std::cout << "Room edges walled: ";
+    if(grid.IsWall(10, 10) && grid.Edge(10, 10, TopWall).IsBlocked && grid.Edge(10, 10, LeftWall).IsBlocked &&
+       !grid.Edge(10, 10, RightWall).IsBlocked && grid.IsRoom(20, 20) && !grid.IsWall(20, 20) && !grid.IsFloor(5, 5))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    count++;
+    std::cout << "Corridor walled along its sides: ";
+    if(grid.IsFloor(45, 20) && !grid.IsRoom(45, 20) && grid.Edge(45, 20, TopWall).IsBlocked &&
+       grid.Edge(45, 20, BottomWall).IsBlocked && !grid.Edge(45, 20, LeftWall).IsBlocked && !grid.Edge(45, 20, RightWall).IsBlocked)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Doors into rooms start closed, both tiles either side hold the edge
+    count++;
+    std::cout << "Closed door blocks its edge: ";
+    if(grid.IsDoor(30, 20) && grid.Edge(30, 20, RightWall).IsBlocked && grid.Edge(31, 20, LeftWall).IsBlocked &&
+       !grid.Edge(30, 20, RightWall).IsDestructable)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Solid wall rings the floor, corners included, and the corridor's first tile is a doorway
+    count++;
+    std::cout << "Boundary and doorways: ";
+    if(grid.IsBoundary(9, 9) && grid.IsBoundary(45, 19) && grid.IsBoundary(45, 21) && !grid.IsBoundary(45, 20) &&
+       !grid.IsBoundary(20, 20) && !grid.IsBoundary(5, 5) && grid.IsDoorway(31, 20) && grid.IsDoorway(59, 20) && !grid.IsDoorway(45, 20))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // A window sees the same edges as the whole map along its border
+    TileGrid window;
+    window.Rasterise(info, IRect(25, 15, 10, 10));
+    bool same = true;
+    for(int32 y = 0; y < 10; y++)
+    {
+        for(int32 x = 0; x < 10; x++)
+        {
+            for(int32 side = TopWall; side <= LeftWall; side++)
+            {
+                same = same && (window.Edge(x, y, side).IsBlocked == grid.Edge(x + 25, y + 15, side).IsBlocked);
+            }
+        }
+    }
+    
+    count++;
+    std::cout << "Window matches whole map: ";
+    if(same)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Chunks rasterised on demand agree with the whole map
+    TileChunks chunks(info);
+    same = true;
+    for(int32 y = 0; y < info.Height; y++)
+    {
+        for(int32 x = 0; x < info.Width; x++)
+        {
+            same = same && (chunks.IsFloor(x, y) == grid.IsFloor(x, y)) && (chunks.IsDoor(x, y) == grid.IsDoor(x, y));
+            for(int32 side = TopWall; side <= LeftWall; side++)
+            {
+                same = same && (chunks.Edge(x, y, side).IsBlocked == grid.Edge(x, y, side).IsBlocked);
+            }
+        }
+    }
+    
+    count++;
+    std::cout << "Chunks match whole map: ";
+    if(same && chunks.Materialised() == 2)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << chunks.Materialised() << " chunks\n";
+    }
+    
+    count++;
+    std::cout << "Empty chunks shared: ";
+    if(&chunks.Chunk(5, 5) == &chunks.Chunk(-3, 7) && !chunks.IsFloor(400, 400) && chunks.Materialised() == 2)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << chunks.Materialised() << " chunks\n";
+    }
+    
+    deleteContainerContents(info.Rooms);
+    deleteContainerContents(info.Corridors);
+    deleteContainerContents(info.Doors);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Small maps that generate quickly, tests change only the fields they care about.
+static GenerationParams testParams()
+{
+    GenerationParams params;
+    params.Width = 128;
+    params.Height = 128;
+    params.RoomCount = 40;
+    params.MinRoomLength = 4;
+    params.MaxRoomLength = 16;
+    params.Spread = 40;
+    params.Margin = 4;
+    params.MaxSeparateSteps = 200;
+    params.MinRatio = 1.f / 3.f;
+    params.MinRoomWidth = 5;
+    params.MaxRoomWidth = 15;
+    params.MinRoomHeight = 5;
+    params.MaxRoomHeight = 8;
+    params.MaxRooms = 15;
+    params.MaxRandomCorridors = 3;
+    params.Routing = AStarRouting;
+    params.Weighting = UniformWeighting;
+    return params;
+}
+
+void TestCase::RunWorldTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    GenerationParams params = testParams();
+    
+    // A region comes out the same whatever was generated before it
+    MapWorld world(99, params, 1 << 20, 1);
+    MapWorld other(99, params, 1 << 20, 0);
+    other.Region(1, 0);
+    std::shared_ptr<const WorldRegion> a = world.Region(0, 0);
+    std::shared_ptr<const WorldRegion> b = other.Region(0, 0);
+    
+    bool same = (a->Map.Rooms.size() == b->Map.Rooms.size()) && (a->Map.Corridors.size() == b->Map.Corridors.size());
+    for(size_t i = 0; same && i < a->Map.Corridors.size(); i++)
+    {
+        same = (a->Map.Corridors[i]->Path.size() == b->Map.Corridors[i]->Path.size()) &&
+               (a->Map.Corridors[i]->SX == b->Map.Corridors[i]->SX) && (a->Map.Corridors[i]->SY == b->Map.Corridors[i]->SY);
+    }
+    
+    count++;
+    std::cout << "Region independent of order: ";
+    if(same && a->Map.Rooms.size() > 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << a->Map.Rooms.size() << " vs " << b->Map.Rooms.size() << " rooms\n";
+    }
+    
+    // Neighbouring regions reach the two sides of their shared edge
+    std::shared_ptr<const WorldRegion> right = world.Region(1, 0);
+    IPoint left = world.Connector(0, 0, RightWall);
+    IPoint across = world.Connector(1, 0, LeftWall);
+    TileGrid tilesA, tilesB;
+    tilesA.Rasterise(a->Map, a->Bounds);
+    tilesB.Rasterise(right->Map, right->Bounds);
+    
+    count++;
+    std::cout << "Regions stitched at connectors: ";
+    if(across.X == left.X + 1 && across.Y == left.Y &&
+       tilesA.IsFloor(left.X - a->Bounds.Left(), left.Y - a->Bounds.Top()) &&
+       tilesB.IsFloor(across.X - right->Bounds.Left(), across.Y - right->Bounds.Top()))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << left.toString() << " " << across.toString() << "\n";
+    }
+    
+    world.SetFocus(-10, -10);
+    world.WaitForPrefetch();
+    
+    count++;
+    std::cout << "Regions around focus prefetched: ";
+    if(world.FindRegion(-2, -2) && world.FindRegion(0, 0) && !world.FindRegion(1, 1))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << world.CachedRegions() << " regions\n";
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Indices of the entries of List in All, -1 for any not there.
+template<typename T>
+static std::vector<int32> indicesIn(const std::vector<T*>& List, const std::vector<T*>& All)
+{
+    std::vector<int32> indices;
+    for(const T* item : List)
+    {
+        auto found = std::find(All.begin(), All.end(), item);
+        indices.push_back(found == All.end() ? -1 : (int32)(found - All.begin()));
+    }
+    return indices;
+}
+
+// Rooms, features and corridors of two maps list the same corridors and features in the same order.
+static bool sameLinks(const MapInfoType& A, const MapInfoType& B)
+{
+    if(A.Rooms.size() != B.Rooms.size() || A.CorridorFeatures.size() != B.CorridorFeatures.size() || A.Corridors.size() != B.Corridors.size())
+    {
+        return false;
+    }
+    
+    for(size_t i = 0; i < A.Rooms.size(); i++)
+    {
+        if(indicesIn(A.Rooms[i]->Corridors, A.Corridors) != indicesIn(B.Rooms[i]->Corridors, B.Corridors)) return false;
+    }
+    for(size_t i = 0; i < A.CorridorFeatures.size(); i++)
+    {
+        if(indicesIn(A.CorridorFeatures[i]->Corridors, A.Corridors) != indicesIn(B.CorridorFeatures[i]->Corridors, B.Corridors)) return false;
+    }
+    for(size_t i = 0; i < A.Corridors.size(); i++)
+    {
+        if(indicesIn(A.Corridors[i]->Features, A.CorridorFeatures) != indicesIn(B.Corridors[i]->Features, B.CorridorFeatures)) return false;
+    }
+    return true;
+}
+
+void TestCase::RunMapFileTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 100, 50);
+    info.Seed = 42;
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(60, 10, 20, 20));
+    info.CorridorFeatures.push_back(new CorridorFeature(40, 16, 6, 6));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges, AStarRouting);
+    UMapBuilderLib::PlaceDoors(info);
+    UMapBuilderLib::LinkCorridorFeatures(info);
+    TileGrid grid;
+    grid.Rasterise(info);
+    
+    const char* path = "MapFileTest.bin";
+    bool saved = MapFile::Save(path, info, &edges, &grid);
+    MappedMap file;
+    bool opened = file.Open(path);
+    
+    count++;
+    std::cout << "Save and map file: ";
+    if(saved && opened && file.Header().Seed == 42 && file.RoomCount() == 2 && file.CorridorCount() == 1 &&
+       file.FeatureCount() == 1 && file.DoorCount() == (int32)info.Doors.size() && file.EdgeCount() == 1 &&
+       file.Features()[0].LinkedCorridor == 0 && file.Doors()[0].LinkedRoom == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - saved " << saved << " opened " << opened << "\n";
+    }
+    
+    // Tile rows are the rasterised words, untouched
+    bool same = opened && file.HasTiles() && file.Tiles().Width == grid.Width() && file.Tiles().Height == grid.Height();
+    for(int32 p = 0; same && p < TilePlaneCount; p++)
+    {
+        for(int32 y = 0; same && y < grid.Height(); y++)
+        {
+            for(int32 i = 0; same && i < grid.Plane(p).Stride(); i++)
+            {
+                same = (file.TileRow(p, y)[i] == grid.Plane(p).Row(y)[i]);
+            }
+        }
+    }
+    
+    count++;
+    std::cout << "Tile planes read in place: ";
+    if(same)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    MapInfoType loaded = {};
+    if(opened)
+    {
+        file.ToMapInfo(loaded);
+    }
+    
+    same = (loaded.Corridors.size() == 1) && (loaded.Corridors[0]->Path.size() == info.Corridors[0]->Path.size());
+    for(size_t i = 0; same && i < info.Corridors[0]->Path.size(); i++)
+    {
+        same = (loaded.Corridors[0]->Path[i].X == info.Corridors[0]->Path[i].X) && (loaded.Corridors[0]->Path[i].Y == info.Corridors[0]->Path[i].Y);
+    }
+    
+    count++;
+    std::cout << "Rebuilt map matches: ";
+    if(same && loaded.CorridorFeatures.size() == 1 && loaded.CorridorFeatures[0]->LinkedCorridor == loaded.Corridors[0] &&
+       loaded.Doors.size() == info.Doors.size() && loaded.Rooms[0]->Corridors.size() == 1)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Generated maps come back with every room, feature and corridor list as it was
+    bool lists = true;
+    GenerationParams params = testParams();
+    for(int32 seed = 1; seed <= 30 && lists; seed++)
+    {
+        MapInfoType made = {};
+        MapInfoType reloaded = {};
+        UMapBuilderLib::GenerateMap(made, params, seed);
+        MappedMap round;
+        lists = MapFile::Save(path, made, nullptr, nullptr) && round.Open(path);
+        if(lists)
+        {
+            round.ToMapInfo(reloaded);
+            lists = sameLinks(made, reloaded);
+        }
+        UMapBuilderLib::ClearMap(made);
+        UMapBuilderLib::ClearMap(reloaded);
+    }
+    
+    count++;
+    std::cout << "Corridor lists round trip: ";
+    if(lists)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    file.Close();
+    
+    // A tile section claiming a width near INT_MAX, with a matching stride, is refused
+    bool wideSaved = MapFile::Save(path, info, &edges, &grid) && file.Open(path);
+    uint64_t tilesOffset = wideSaved ? file.Header().Tiles.Offset : 0;
+    file.Close();
+    FILE* wide = wideSaved ? fopen(path, "r+b") : 0;
+    if(wide != 0)
+    {
+        int32_t width = INT_MAX;
+        int32_t stride = (int32_t)(((int64_t)width + 63) / 64);
+        fseek(wide, (long)(tilesOffset + offsetof(MapFileTiles, Width)), SEEK_SET);
+        fwrite(&width, sizeof(width), 1, wide);
+        fseek(wide, (long)(tilesOffset + offsetof(MapFileTiles, Stride)), SEEK_SET);
+        fwrite(&stride, sizeof(stride), 1, wide);
+        fclose(wide);
+    }
+    MappedMap huge;
+    
+    count++;
+    std::cout << "Huge tile width refused: ";
+    if(wide != 0 && !huge.Open(path) && !huge.IsOpen())
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // A file that does not start with the magic is refused
+    FILE* cut = fopen(path, "r+b");
+    if(cut != 0)
+    {
+        fputs("x", cut);
+        fclose(cut);
+    }
+    MappedMap corrupt;
+    
+    count++;
+    std::cout << "Bad header refused: ";
+    if(!corrupt.Open(path) && !corrupt.IsOpen())
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    remove(path);
+    
+    UMapBuilderLib::ClearMap(info);
+    UMapBuilderLib::ClearMap(loaded);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunTileCodecTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 150, 70);
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(100, 30, 30, 25));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges, AStarRouting);
+    UMapBuilderLib::PlaceDoors(info);
+    TileGrid grid;
+    grid.Rasterise(info);
+    
+    std::vector<uint8_t> data;
+    bool ok = TileCodec::Encode(grid, data);
+    TileGrid decoded;
+    ok = ok && TileCodec::Decode(data.data(), data.size(), decoded);
+    bool same = ok && decoded.Width() == grid.Width() && decoded.Height() == grid.Height();
+    for(int32 p = 0; same && p < TilePlaneCount; p++)
+    {
+        for(int32 y = 0; same && y < grid.Height(); y++)
+        {
+            for(int32 i = 0; same && i < grid.Plane(p).Stride(); i++)
+            {
+                same = (decoded.Plane(p).Row(y)[i] == grid.Plane(p).Row(y)[i]);
+            }
+        }
+    }
+    
+    count++;
+    std::cout << "Exact round trip: ";
+    if(same)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << data.size() << " bytes\n";
+    }
+    
+    // One chunk straddling a room edge, decoded without the rest of the grid
+    IRect window(90, 20, 64, 64);
+    ok = TileCodec::Decode(data.data(), data.size(), window, decoded);
+    same = ok && decoded.Width() == 60 && decoded.Height() == 50 && decoded.Origin().X == 90 && decoded.Origin().Y == 20;
+    for(int32 p = 0; same && p < TilePlaneCount; p++)
+    {
+        for(int32 y = 0; same && y < decoded.Height(); y++)
+        {
+            for(int32 x = 0; same && x < decoded.Width(); x++)
+            {
+                same = (decoded.Plane(p).Get(x, y) == grid.Plane(p).Get(x + 90, y + 20));
+            }
+        }
+    }
+    
+    count++;
+    std::cout << "Window decode: ";
+    if(same)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << decoded.Width() << "x" << decoded.Height() << "\n";
+    }
+    
+    // Truncated and damaged data is refused rather than read past its end
+    std::vector<uint8_t> cut(data.begin(), data.begin() + data.size() / 2);
+    std::vector<uint8_t> damaged = data;
+    damaged[sizeof(TileCodecHeader) + 4] = 0xFF;
+    
+    // A header asking for a huge width over one empty row is refused before the planes are sized
+    TileCodecHeader wide;
+    memcpy(&wide, data.data(), sizeof(wide));
+    wide.Width = 0x7FFFFFFF;
+    wide.Height = 1;
+    std::vector<uint8_t> huge(sizeof(wide) + 2 * sizeof(uint32_t), 0);
+    memcpy(huge.data(), &wide, sizeof(wide));
+    
+    count++;
+    std::cout << "Bad data refused: ";
+    if(!TileCodec::Decode(cut.data(), cut.size(), decoded) && decoded.Width() == 0 &&
+       !TileCodec::Decode(damaged.data(), damaged.size(), decoded) &&
+       !TileCodec::Decode(huge.data(), huge.size(), decoded) && decoded.Width() == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Grids at the largest side round trip, one past it is refused by Encode, and a header
+    // past the tile count limit is refused by Decode
+    bool limits = true;
+    IRect sizes[4] = { IRect(0, 20, TileCodecMaxSide, 2), IRect(20, 0, 2, TileCodecMaxSide),
+                       IRect(0, 0, TileCodecMaxSide + 1, 1), IRect(0, 0, 1, TileCodecMaxSide + 1) };
+    for(int32 i = 0; limits && i < 4; i++)
+    {
+        TileGrid big;
+        big.Rasterise(info, sizes[i]);
+        bool fits = (i < 2);
+        limits = (TileCodec::Encode(big, data) == fits) && (data.empty() != fits);
+        if(!limits || !fits) continue;
+        
+        limits = TileCodec::Decode(data.data(), data.size(), decoded) &&
+                 decoded.Width() == big.Width() && decoded.Height() == big.Height();
+        for(int32 p = 0; limits && p < TilePlaneCount; p++)
+        {
+            for(int32 y = 0; limits && y < big.Height(); y++)
+            {
+                for(int32 w = 0; limits && w < big.Plane(p).Stride(); w++)
+                {
+                    limits = (decoded.Plane(p).Row(y)[w] == big.Plane(p).Row(y)[w]);
+                }
+            }
+        }
+    }
+    
+    TileCodecHeader square = wide;
+    square.Width = 16385;
+    square.Height = 16385;
+    std::vector<uint8_t> many(sizeof(square) + (16385 + 1) * sizeof(uint32_t), 0);
+    memcpy(many.data(), &square, sizeof(square));
+    
+    count++;
+    std::cout << "Size limits: ";
+    if(limits && !TileCodec::Decode(many.data(), many.size(), decoded) && decoded.Width() == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    UMapBuilderLib::ClearMap(info);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Everything written to a temporary file by Write, read back as one string.
+template<typename Writer>
+static std::string exportText(Writer Write)
+{
+    std::string text;
+    FILE* file = tmpfile();
+    if(file == 0) return text;
+    
+    {
+        BufferedSink out(file);
+        Write(out);
+    }
+    rewind(file);
+    char chunk[4096];
+    size_t n;
+    while((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        text.append(chunk, n);
+    }
+    fclose(file);
+    return text;
+}
+
+void TestCase::RunExportTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 40, 30);
+    info.Seed = -5;
+    info.Rooms.push_back(new Room(2, 3, 10, 12));
+    Corridor* corridor = new Corridor();
+    corridor->SX = 12;
+    corridor->SY = 8;
+    corridor->EX = 30;
+    corridor->EY = 20;
+    corridor->Path.push_back(IPoint(12, 8));
+    corridor->Path.push_back(IPoint(30, 8));
+    corridor->Path.push_back(IPoint(30, 20));
+    info.Corridors.push_back(corridor);
+    DoorType type = { false, true, false, false };
+    info.Doors.push_back(new Door(12, 8, RightWall, type));
+    
+    std::string json = exportText([&](BufferedSink& out) { MapExport::WriteJson(out, info); });
+    
+    count++;
+    std::cout << "JSON export: ";
+    if(json == "{\n\"seed\":-5,\n\"width\":40,\n\"height\":30,\n"
+               "\"rooms\":[\n{\"x\":2,\"y\":3,\"width\":10,\"height\":12,\"enabled\":true}],\n"
+               "\"features\":[],\n"
+               "\"corridors\":[\n{\"start\":[12,8],\"end\":[30,20],\"path\":[[12,8],[30,8],[30,20]]}],\n"
+               "\"doors\":[\n{\"x\":12,\"y\":8,\"wall\":\"right\",\"open\":false,\"locked\":true,\"destructable\":false,\"hidden\":false}]\n}\n")
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << json << "\n";
+    }
+    
+    std::string csv = exportText([&](BufferedSink& out) { MapExport::WriteCsv(out, info); });
+    
+    count++;
+    std::cout << "CSV export: ";
+    if(csv == "kind,id,x,y,width,height,info\n"
+              "room,0,2,3,10,12,enabled\n"
+              "corridor,0,12,8,1,1,\n"
+              "corridor,0,30,8,1,1,\n"
+              "corridor,0,30,20,1,1,\n"
+              "door,0,12,8,1,1,right closed locked\n")
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << csv << "\n";
+    }
+    
+    // The tile layer holds one id per tile
+    TileGrid grid;
+    grid.Rasterise(info);
+    std::string tmx = exportText([&](BufferedSink& out) { MapExport::WriteTmx(out, info, &grid); });
+    size_t data = tmx.find("<data encoding=\"csv\">\n");
+    size_t tiles = 0;
+    for(size_t i = data; data != std::string::npos && i < tmx.find("</data>"); i++)
+    {
+        tiles += (tmx[i] == ',');
+    }
+    
+    count++;
+    std::cout << "TMX export: ";
+    if(tiles + 1 == 40 * 30 && tmx.find("nextobjectid=\"4\"") != std::string::npos && tmx.find("<polyline points=\"0,0 288,0 288,192\"/>") != std::string::npos)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << tiles << " tiles\n";
+    }
+    
+    UMapBuilderLib::ClearMap(info);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunMapCacheTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    GenerationParams params = testParams();
+    
+    const char* directory = "MapCacheTest";
+    MapCache cache(directory, 1 << 20);
+    MapInfoType made = {};
+    MapInfoType loaded = {};
+    bool first = cache.Fetch(made, params, 7);
+    bool second = cache.Fetch(loaded, params, 7);
+    
+    bool same = (made.Rooms.size() == loaded.Rooms.size()) && (made.Corridors.size() == loaded.Corridors.size()) && (made.Doors.size() == loaded.Doors.size());
+    for(size_t i = 0; same && i < made.Rooms.size(); i++)
+    {
+        const IRect& a = made.Rooms[i]->Bounds;
+        const IRect& b = loaded.Rooms[i]->Bounds;
+        same = (a.Position.X == b.Position.X) && (a.Position.Y == b.Position.Y) && (a.Width == b.Width) && (a.Height == b.Height);
+    }
+    
+    count++;
+    std::cout << "Second fetch hits: ";
+    if(!first && second && same && cache.Hits() == 1 && cache.Misses() == 1)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - hits " << cache.Hits() << " misses " << cache.Misses() << "\n";
+    }
+    
+    // Anything that changes the map changes the key
+    GenerationParams changed = params;
+    changed.MaxRandomCorridors = 4;
+    CircleFilter inside(64, 64, 30);
+    CircleFilter outside(64, 64, 30, false);
+    std::vector<RoomFilter*> insideFilters(1, &inside);
+    std::vector<RoomFilter*> outsideFilters(1, &outside);
+    std::vector<IPoint> connectors(1, IPoint(0, 64));
+    std::vector<IPoint> none;
+    uint64_t key = MapCache::Key(params, 7);
+    
+    count++;
+    std::cout << "Keys differ: ";
+    if(key == MapCache::Key(params, 7, nullptr) && key != MapCache::Key(params, 8) && key != MapCache::Key(changed, 7) &&
+       key != MapCache::Key(params, 7, &insideFilters) && MapCache::Key(params, 7, &insideFilters) != MapCache::Key(params, 7, &outsideFilters) &&
+       key != MapCache::Key(params, 7, nullptr, &connectors) && key == MapCache::Key(params, 7, nullptr, &none))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Without a Generate the filters are still applied, so the map stored is the filtered one
+    MapInfoType filtered = {};
+    MapInfoType refetched = {};
+    MapInfoType direct = {};
+    bool filteredHit = cache.Fetch(filtered, params, 7, &insideFilters);
+    bool refetchedHit = cache.Fetch(refetched, params, 7, &insideFilters);
+    UMapBuilderLib::GenerateMap(direct, params, 7, nullptr, &insideFilters);
+    same = (filtered.Rooms.size() == direct.Rooms.size()) && (refetched.Rooms.size() == direct.Rooms.size()) && (direct.Rooms.size() != made.Rooms.size());
+    for(size_t i = 0; same && i < direct.Rooms.size(); i++)
+    {
+        const IRect& a = direct.Rooms[i]->Bounds;
+        const IRect& b = refetched.Rooms[i]->Bounds;
+        same = (a.Position.X == b.Position.X) && (a.Position.Y == b.Position.Y) && (a.Width == b.Width) && (a.Height == b.Height);
+    }
+    
+    count++;
+    std::cout << "Filtered fetch: ";
+    if(!filteredHit && refetchedHit && same)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << direct.Rooms.size() << " rooms filtered, " << refetched.Rooms.size() << " fetched\n";
+    }
+    UMapBuilderLib::ClearMap(filtered);
+    UMapBuilderLib::ClearMap(refetched);
+    UMapBuilderLib::ClearMap(direct);
+    
+    // A cache with room for about one map keeps only the latest
+    MapCache small(directory, 1);
+    MapInfoType other = {};
+    small.Fetch(other, params, 8);
+    FILE* kept = fopen(small.PathOf(MapCache::Key(params, 8)).c_str(), "rb");
+    FILE* evicted = fopen(small.PathOf(key).c_str(), "rb");
+    
+    count++;
+    std::cout << "Size limit evicts: ";
+    if(kept != 0 && evicted == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    if(kept != 0) fclose(kept);
+    if(evicted != 0) fclose(evicted);
+    
+    small.Evict();
+    remove((std::string(directory) + "/lock").c_str());
+    remove(directory);
+    
+    UMapBuilderLib::ClearMap(made);
+    UMapBuilderLib::ClearMap(loaded);
+    UMapBuilderLib::ClearMap(other);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+static bool sameColour(const MapColour& a, const MapColour& b)
+{
+    return a.R == b.R && a.G == b.G && a.B == b.B && a.A == b.A;
+}
+
+void TestCase::RunRasterTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 64, 64);
+    info.Rooms.push_back(new Room(8, 8, 10, 10));
+    info.CorridorFeatures.push_back(new CorridorFeature(40, 40, 8, 8));
+    Corridor* corridor = new Corridor();
+    corridor->Path.push_back(IPoint(18, 12));
+    corridor->Path.push_back(IPoint(44, 12));
+    corridor->Path.push_back(IPoint(44, 40));
+    info.Corridors.push_back(corridor);
+    DoorType type = { true, false, false, false };
+    info.Doors.push_back(new Door(18, 12, RightWall, type));
+    
+    MapImage image(128, 128);
+    MapRenderer::Draw(info, image, 2.f);
+    
+    count++;
+    std::cout << "Map drawn in map colours: ";
+    if(sameColour(image.Pixel(16, 16), RoomLineColour) && sameColour(image.Pixel(20, 20), RoomFillColour) &&
+       sameColour(image.Pixel(84, 84), CorridorFillColour) && sameColour(image.Pixel(60, 24), CorridorLineColour) &&
+       sameColour(image.Pixel(36, 24), DoorColour) && sameColour(image.Pixel(2, 100), BackgroundColour))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Lines far outside the image are clipped rather than written out of bounds
+    MapImage small(16, 8);
+    small.Line(-1000.f, 4.f, 1000.f, 4.f, DoorColour);
+    small.Line(-50.f, -50.f, -10.f, 70.f, RoomLineColour);
+    bool clipped = true;
+    for(int32 x = 0; x < small.Width(); x++)
+    {
+        clipped = clipped && sameColour(small.Pixel(x, 4), DoorColour) && sameColour(small.Pixel(x, 3), BackgroundColour);
+    }
+    
+    count++;
+    std::cout << "Lines clipped: ";
+    if(clipped)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    const char* path = "RasterTest.png";
+    MapImage thumbnail;
+    MapRenderer::Thumbnail(info, thumbnail, 32);
+    bool saved = thumbnail.SavePng(path);
+    unsigned char signature[8] = {};
+    FILE* file = fopen(path, "rb");
+    if(file != 0)
+    {
+        fread(signature, 1, sizeof(signature), file);
+        fseek(file, 0, SEEK_END);
+    }
+    // Signature, three chunks of 12 bytes, the header, and the zlib stream around 32 rows of 129 bytes.
+    long expected = 8 + 3 * 12 + 13 + (2 + 5 + 32 * 129 + 4);
+    
+    count++;
+    std::cout << "PNG written: ";
+    if(saved && file != 0 && signature[0] == 0x89 && signature[1] == 'P' && ftell(file) == expected)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    if(file != 0) fclose(file);
+    remove(path);
+    
+    // Thumbnails made in a batch on several threads carry each map's overlay, the same as one at a time
+    GenerationParams params = testParams();
+    MapInfoType maps[3] = {};
+    Triangulation* tris[3];
+    std::list<int32>* spans[3];
+    MapOverlay overlays[3];
+    std::vector<const MapInfoType*> batch;
+    std::vector<const MapOverlay*> batchOverlays;
+    for(int32 m = 0; m < 3; m++)
+    {
+        UMapBuilderLib::GenerateMap(maps[m], params, 20 + m);
+        tris[m] = UMapBuilderLib::PerformDelaunayTriangulation(maps[m]);
+        spans[m] = UMapBuilderLib::CalcMinSpan(maps[m], *tris[m]);
+        overlays[m].Tri = tris[m];
+        overlays[m].MinSpan = spans[m];
+        batch.push_back(&maps[m]);
+        batchOverlays.push_back(m == 1 ? nullptr : &overlays[m]);
+    }
+    
+    std::vector<MapImage> thumbnails;
+    MapRenderer::Thumbnails(batch, thumbnails, 96, batchOverlays, 3);
+    bool overlaid = (thumbnails.size() == 3);
+    bool changed = false;
+    for(int32 m = 0; overlaid && m < 3; m++)
+    {
+        MapImage single;
+        MapImage plain;
+        MapRenderer::Thumbnail(maps[m], single, 96, batchOverlays[m]);
+        MapRenderer::Thumbnail(maps[m], plain, 96);
+        for(int32 y = 0; overlaid && y < 96; y++)
+        {
+            for(int32 x = 0; overlaid && x < 96; x++)
+            {
+                overlaid = sameColour(thumbnails[m].Pixel(x, y), single.Pixel(x, y));
+                if(m != 1 && !sameColour(single.Pixel(x, y), plain.Pixel(x, y))) changed = true;
+            }
+        }
+    }
+    
+    count++;
+    std::cout << "Batch thumbnail overlays: ";
+    if(overlaid && changed)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    for(int32 m = 0; m < 3; m++)
+    {
+        delete tris[m];
+        delete spans[m];
+        UMapBuilderLib::ClearMap(maps[m]);
+    }
+    
+    UMapBuilderLib::ClearMap(info);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunDistanceFieldTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Two rooms joined by a straight corridor along y = 20, doors open
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 100, 50);
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(60, 10, 20, 20));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges);
+    UMapBuilderLib::PlaceDoors(info);
+    for(Door* d : info.Doors)
+    {
+        d->Type.IsOpen = true;
+    }
+    TileGrid grid;
+    grid.Rasterise(info);
+    
+    std::vector<IPoint> sources(1, IPoint(20, 20));
+    DistanceField field;
+    field.Compute(grid, sources);
+    
+    count++;
+    std::cout << "Distances through the corridor: ";
+    if(field.At(20, 20) == 0 && field.At(25, 24) == 9 && field.At(45, 20) == 25 && field.At(70, 20) == 50 &&
+       field.At(45, 19) == DistanceField::Unreachable && field.At(5, 5) == DistanceField::Unreachable)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << field.At(45, 20) << " " << field.At(70, 20) << "\n";
+    }
+    
+    // Sharing the rings between threads gives the same field, and closed doors stop it
+    sources.push_back(IPoint(75, 12));
+    DistanceField serial, shared;
+    serial.Compute(grid, sources, 1);
+    shared.Compute(grid, sources, 4);
+    bool same = true;
+    for(int32 i = 0; i < grid.Width() * grid.Height(); i++)
+    {
+        same = same && (serial.Data()[i] == shared.Data()[i]);
+    }
+    info.Doors[0]->Type.IsOpen = false;
+    TileGrid closed;
+    closed.Rasterise(info);
+    DistanceField blocked;
+    blocked.Compute(closed, std::vector<IPoint>(1, IPoint(20, 20)));
+    
+    count++;
+    std::cout << "Threads agree, doors block: ";
+    if(same && serial.At(70, 20) == 13 && blocked.At(45, 20) == DistanceField::Unreachable && blocked.At(29, 29) == 18)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Corridor tiles cost more, so the cheapest way to them is the same way at a higher price
+    std::vector<uint8_t> costs(grid.Width() * grid.Height(), 1);
+    for(int32 x = 31; x < 60; x++)
+    {
+        costs[20 * grid.Width() + x] = 3;
+    }
+    DistanceField weighted;
+    weighted.Compute(grid, std::vector<IPoint>(1, IPoint(20, 20)), costs.data());
+    std::vector<uint8_t> flow;
+    field.Flow(grid, flow);
+    
+    count++;
+    std::cout << "Costs and flow: ";
+    if(weighted.At(45, 20) == 10 + 15 * 3 && weighted.At(70, 20) == 10 + 29 * 3 + 11 &&
+       flow[20 * grid.Width() + 45] == LeftWall && flow[20 * grid.Width() + 20] == FlowNone && flow[5 * grid.Width() + 5] == FlowNone)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << weighted.At(45, 20) << " " << weighted.At(70, 20) << "\n";
+    }
+    
+    UMapBuilderLib::ClearMap(info);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunValidatorTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Two rooms joined by a corridor with closed doors, and a third on its own
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 200, 50);
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(100, 10, 20, 20));
+    info.Rooms.push_back(new Room(160, 10, 20, 20));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges);
+    UMapBuilderLib::PlaceDoors(info);
+    TileGrid grid;
+    grid.Rasterise(info);
+    
+    ConnectivityReport report;
+    bool connected = MapValidator::Check(info, grid, report);
+    
+    count++;
+    std::cout << "Unreachable rooms: ";
+    if(!connected && report.Components == 2 && report.Main == 0 && report.Unreachable.size() == 1 && report.Unreachable[0] == 2 &&
+       report.Component[1] == 0 && report.ReachedTiles == 21 * 21 * 2 + 69 && report.FloorTiles == 21 * 21 * 3 + 69)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << report.Components << " components, " << report.ReachedTiles << " of " << report.FloorTiles << " tiles\n";
+    }
+    
+    // A plain fill stops at the closed doors, across the word boundaries of the corridor
+    BitGrid reached(grid.Width(), grid.Height());
+    MapValidator::Fill(grid, IPoint(70, 20), reached);
+    bool corridor = true;
+    for(int32 x = 31; x < 100; x++)
+    {
+        corridor = corridor && reached.Get(x, 20);
+    }
+    
+    count++;
+    std::cout << "Fill stops at closed doors: ";
+    if(corridor && !reached.Get(30, 20) && !reached.Get(100, 20) && !reached.Get(20, 20) && !reached.Get(70, 21))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Repair routes a corridor to the lone room, and generated maps come out whole
+    int32 before = info.Corridors.size();
+    bool repaired = MapValidator::Validate(info, report);
+    bool generated = true;
+    GenerationParams params = testParams();
+    params.RoomCount = 60;
+    params.MaxRooms = 25;
+    params.Routing = StraightRouting;
+    for(int32 seed = 1; seed <= 10; seed++)
+    {
+        MapInfoType map = {};
+        UMapBuilderLib::GenerateMap(map, params, seed);
+        TileGrid tiles;
+        tiles.Rasterise(map);
+        ConnectivityReport check;
+        generated = generated && MapValidator::Check(map, tiles, check);
+        UMapBuilderLib::ClearMap(map);
+    }
+    
+    count++;
+    std::cout << "Repair: ";
+    if(repaired && report.Components == 1 && report.Unreachable.empty() && (int32)info.Corridors.size() == before + 1 && generated)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << report.Components << " components\n";
+    }
+    
+    UMapBuilderLib::ClearMap(info);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunVertexTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    MapInfoType info = {};
+    UMapBuilderLib::InitMap(info, 100, 50);
+    info.Rooms.push_back(new Room(10, 10, 20, 20));
+    info.Rooms.push_back(new Room(60, 10, 20, 20));
+    info.CorridorFeatures.push_back(new CorridorFeature(40, 30, 5, 5));
+    std::list<int32> edges;
+    edges.push_back(0);
+    edges.push_back(1);
+    UMapBuilderLib::GenerateCorridors(info, edges);
+    UMapBuilderLib::PlaceDoors(info);
+    
+    // Every room is two triangles and four lines, at the builder's scale
+    MapVertexBuilder builder(2.f);
+    builder.BuildRooms(info);
+    builder.BuildCorridorFeatures(info);
+    const std::vector<MapVertex>& fill = builder.Layer(RoomFillLayer);
+    const std::vector<MapVertex>& lines = builder.Layer(RoomLineLayer);
+    bool inside = true;
+    for(int32 i = 0; i < MapVertexBuilder::BoxFillVertices; i++)
+    {
+        const MapVertex& v = fill[MapVertexBuilder::BoxFillVertices + i];
+        inside = inside && v.X >= 120.f && v.X <= 160.f && v.Y >= 20.f && v.Y <= 60.f && v.Colour.G == RoomFillColour.G;
+    }
+    
+    count++;
+    std::cout << "Rooms and features: ";
+    if(fill.size() == 2 * MapVertexBuilder::BoxFillVertices && lines.size() == 2 * MapVertexBuilder::BoxLineVertices && inside &&
+       lines[0].X == 20.f && lines[0].Y == 20.f && lines[1].X == 60.f && lines[1].Y == 20.f && lines[0].Colour.R == RoomLineColour.R &&
+       builder.Layer(FeatureFillLayer).size() == MapVertexBuilder::BoxFillVertices && builder.Layer(FeatureLineLayer)[0].Colour.B == CorridorLineColour.B &&
+       MapVertexBuilder::IsTriangles(RoomFillLayer) && !MapVertexBuilder::IsTriangles(RoomLineLayer))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << fill.size() << " " << lines.size() << "\n";
+    }
+    
+    // One line per corridor segment, a square per door
+    builder.SetScale(1.f);
+    builder.BuildCorridors(info);
+    const std::vector<MapVertex>& corridors = builder.Layer(CorridorLayer);
+    
+    count++;
+    std::cout << "Corridors and doors: ";
+    if(corridors.size() == 2 && corridors[0].X == 30.f && corridors[0].Y == 20.f && corridors[1].X == 60.f &&
+       builder.Layer(DoorLayer).size() == info.Doors.size() * MapVertexBuilder::BoxFillVertices && info.Doors.size() == 2 &&
+       builder.Layer(DoorLayer)[2].X == info.Doors[0]->X + 1.f)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << corridors.size() << " " << builder.Layer(DoorLayer).size() << "\n";
+    }
+    
+    // Only the items overlapping a view are found, the outlines sharing their fills' items
+    builder.BuildRooms(info);
+    std::vector<int32> rooms, outlines, segments, none;
+    builder.Query(RoomFillLayer, IRect(0, 0, 40, 40), rooms);
+    builder.Query(RoomLineLayer, IRect(0, 0, 40, 40), outlines);
+    builder.Query(CorridorLayer, IRect(40, 15, 5, 5), segments);
+    builder.Query(RoomFillLayer, IRect(40, 15, 5, 5), none);
+    builder.Query(DoorLayer, IRect(500, 500, 10, 10), none);
+    
+    count++;
+    std::cout << "View queries: ";
+    if(rooms.size() == 1 && rooms[0] == 0 && outlines == rooms && segments.size() == 1 && none.empty() &&
+       builder.Extent().Left() == 10 && builder.Extent().Right() == 80 && builder.Extent().Bottom() == 30 &&
+       MapVertexBuilder::ItemVertices(RoomPointLayer) == MapVertexBuilder::PointVertices)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << rooms.size() << " " << segments.size() << " " << none.size() << "\n";
+    }
+    
+    // Squares of the density grid are shaded by how much of them rooms cover
+    MapInfoType sparse = {};
+    UMapBuilderLib::InitMap(sparse, 600, 20);
+    sparse.Rooms.push_back(new Room(0, 0, 10, 10));
+    sparse.Rooms.push_back(new Room(500, 0, 10, 10));
+    sparse.Rooms.push_back(new Room(100, 0, 1, 1));
+    MapVertexBuilder density;
+    density.BuildRooms(sparse);
+    const std::vector<MapVertex>& squares = density.Layer(DensityLayer);
+    std::vector<int32> corner;
+    density.Query(DensityLayer, IRect(0, 0, 20, 20), corner);
+    int32 faint = -1;
+    for(size_t i = 0; i < squares.size(); i += MapVertexBuilder::BoxFillVertices)
+    {
+        if(squares[i].X == 100.f) faint = squares[i].Colour.A;
+    }
+    
+    count++;
+    std::cout << "Density squares: ";
+    if(squares.size() == 51 * MapVertexBuilder::BoxFillVertices && corner.size() == 25 && squares[0].Colour.A == 255 &&
+       faint == 64 + 191 / 4 && squares[2].X == 2.f && MapVertexBuilder::IsTriangles(DensityLayer))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << squares.size() / MapVertexBuilder::BoxFillVertices << " " << corner.size() << " " << faint << "\n";
+    }
+    UMapBuilderLib::ClearMap(sparse);
+    
+    // Triangulation and spanning tree edges, then clearing every layer
+    info.Rooms.push_back(new Room(35, 40, 10, 8));
+    Triangulation* tri = UMapBuilderLib::PerformDelaunayTriangulation(info);
+    std::list<int32>* minSpan = UMapBuilderLib::CalcMinSpan(info, *tri);
+    builder.BuildDelaunay(*tri);
+    builder.BuildMinSpan(*minSpan, tri->point);
+    bool built = builder.Layer(DelaunayLayer).size() == (size_t)tri->nEdges * 2 && builder.Layer(MinSpanLayer).size() == 4 &&
+                 builder.Layer(RoomPointLayer).size() == 3 * MapVertexBuilder::PointVertices;
+    builder.ClearAll();
+    bool cleared = true;
+    for(int32 i = 0; i < MapLayerCount; i++)
+    {
+        cleared = cleared && builder.Layer((MapLayer)i).empty();
+    }
+    
+    count++;
+    std::cout << "Delaunay and spanning tree: ";
+    if(built && cleared && tri->nEdges == 3)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << tri->nEdges << " edges\n";
+    }
+    
+    delete minSpan;
+    delete tri;
+    UMapBuilderLib::ClearMap(info);
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+void TestCase::RunTripleBufferTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Only the newest value is read, and nothing changes without a publish
+    TripleBuffer<int32> single;
+    bool empty = !single.Update();
+    single.Back() = 1;
+    single.Publish();
+    single.Back() = 2;
+    single.Publish();
+    bool newest = single.Update() && single.Front() == 2;
+    bool kept = !single.Update() && single.Front() == 2;
+    single.Back() = 3;
+    single.Publish();
+    
+    count++;
+    std::cout << "Newest value: ";
+    if(empty && newest && kept && single.Update() && single.Front() == 3)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // A reader on another thread never sees a value half written, or an older one after a newer
+    TripleBuffer<std::vector<int32> > shared;
+    const int32 publishes = 20000;
+    std::thread writer([&]()
+    {
+        for(int32 v = 1; v <= publishes; v++)
+        {
+            std::vector<int32>& back = shared.Back();
+            back.assign(64, 0);
+            for(int32& x : back)
+            {
+                x = v;
+            }
+            shared.Publish();
+        }
+    });
+    
+    bool whole = true;
+    int32 last = 0;
+    int32 reads = 0;
+    while(last < publishes)
+    {
+        if(!shared.Update()) continue;
+        
+        const std::vector<int32>& front = shared.Front();
+        for(int32 x : front)
+        {
+            whole = whole && (x == front[0]);
+        }
+        whole = whole && (front[0] > last);
+        last = front[0];
+        reads++;
+    }
+    writer.join();
+    
+    count++;
+    std::cout << "Reader and writer threads: ";
+    if(whole && last == publishes && reads > 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << reads << " reads, last " << last << "\n";
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
+
+// Rooms of two maps have the same bounds in the same order.
+static bool sameRooms(const MapInfoType& A, const MapInfoType& B, size_t Count)
+{
+    if(A.Rooms.size() < Count || B.Rooms.size() < Count) return false;
+    
+    for(size_t i = 0; i < Count; i++)
+    {
+        const IRect& a = A.Rooms[i]->Bounds;
+        const IRect& b = B.Rooms[i]->Bounds;
+        if(a.Left() != b.Left() || a.Top() != b.Top() || a.Width != b.Width || a.Height != b.Height) return false;
+    }
+    return true;
+}
+
+void TestCase::RunRandomTests()
+{
+    int count = 0;
+    int pass = 0;
+    
+    // Any value can be reached directly, and streams of one seed differ
+    CounterRand rng(42, RoomStream);
+    std::vector<uint64_t> values;
+    for(int32 i = 0; i < 8; i++)
+    {
+        values.push_back(rng.Next());
+    }
+    CounterRand skipped(42, RoomStream);
+    skipped.Skip(5);
+    CounterRand sought(42, RoomStream);
+    sought.Seek(3);
+    CounterRand other(42, ReduceStream);
+    bool inRange = true;
+    bool hitMin = false;
+    bool hitMax = false;
+    for(int32 i = 0; i < 1000; i++)
+    {
+        int32 r = rng.Range(-3, 3);
+        double d = rng.NextDouble();
+        inRange = inRange && r >= -3 && r <= 3 && d >= 0.0 && d < 1.0 && rng.Below(7) < 7;
+        hitMin = hitMin || r == -3;
+        hitMax = hitMax || r == 3;
+    }
+    
+    count++;
+    std::cout << "Streams and skip ahead: ";
+    if(skipped.Next() == values[5] && sought.Next() == values[3] && sought.Counter() == 4 && rng.At(7) == values[7] &&
+       other.Next() != values[0] && CounterRand(43, RoomStream).Next() != values[0] && inRange && hitMin && hitMax && rng.Below(0) == 0)
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    
+    // Rooms made on many threads are the ones a single thread makes, and don't depend on the process' rand()
+    MapInfoType few = {};
+    MapInfoType many = {};
+    UMapBuilderLib::InitMap(few, 1000, 1000);
+    UMapBuilderLib::InitMap(many, 1000, 1000);
+    UMapBuilderLib::SetSeed(few, 7);
+    UMapBuilderLib::SetSeed(many, 7);
+    srand(1);
+    UMapBuilderLib::MakeRooms(few, 100, 3, 20, 500, 500, 300, 300);
+    srand(2);
+    UMapBuilderLib::MakeRooms(many, 200000, 3, 20, 500, 500, 300, 300);
+    
+    count++;
+    std::cout << "Parallel rooms: ";
+    if(many.Rooms.size() == 200000 && sameRooms(few, many, 100))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL - " << many.Rooms.size() << " rooms\n";
+    }
+    UMapBuilderLib::ClearMap(few);
+    UMapBuilderLib::ClearMap(many);
+    
+    // Whole maps generated at the same time on separate threads match ones made alone
+    GenerationParams params = testParams();
+    params.RoomCount = 60;
+    
+    const int32 maps = 4;
+    MapInfoType alone[maps] = {};
+    MapInfoType together[maps] = {};
+    for(int32 i = 0; i < maps; i++)
+    {
+        UMapBuilderLib::GenerateMap(alone[i], params, 100 + i);
+    }
+    std::vector<std::thread> threads;
+    for(int32 i = 0; i < maps; i++)
+    {
+        threads.push_back(std::thread([&, i]() { UMapBuilderLib::GenerateMap(together[i], params, 100 + i); }));
+    }
+    for(std::thread& t : threads)
+    {
+        t.join();
+    }
+    bool same = true;
+    for(int32 i = 0; i < maps; i++)
+    {
+        same = same && alone[i].Rooms.size() == together[i].Rooms.size() && sameRooms(alone[i], together[i], alone[i].Rooms.size()) &&
+               alone[i].Corridors.size() == together[i].Corridors.size() && alone[i].Doors.size() == together[i].Doors.size();
+    }
+    
+    count++;
+    std::cout << "Concurrent maps: ";
+    if(same && !sameRooms(alone[0], alone[1], 1))
+    {
+        pass++;
+        std::cout << "PASS\n";
+    }
+    else
+    {
+        std::cout << "FAIL\n";
+    }
+    for(int32 i = 0; i < maps; i++)
+    {
+        UMapBuilderLib::ClearMap(alone[i]);
+        UMapBuilderLib::ClearMap(together[i]);
+    }
+    
+    std::cout << "Completed (" + std::to_string(pass) + "/" + std::to_string(count) + ")\n\n";
+}
@@ -0,0 +1,126 @@
+#include "TileChunks.h"
+#include <algorithm>
+
+using namespace std;
+
+void TileChunks::Clear()
+{
+    for(auto& chunk : chunks)
+    {
+        if(chunk.second != &empty)
+        {
+            delete chunk.second;
+        }
+    }
+    chunks.clear();
+    materialised = 0;
+    lastChunk = 0;
+}
+
+void TileChunks::Reset(const MapInfoType& MapInfo)
+{
+    Clear();
+    mapInfo = &MapInfo;
+    
+    MapInfoType none = {};
+    empty.Rasterise(none, IRect(0, 0, ChunkSize, ChunkSize));
+    
+    vector<IRect> boxes;
+    for(const Room* r : MapInfo.Rooms)
+    {
+        boxes.push_back(r->Bounds);
+    }
+    
+    firstFeature = boxes.size();
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        boxes.push_back(f->Bounds);
+    }
+    
+    // Corridors go in a segment at a time, a box around a whole bent corridor would cover many empty chunks.
+    firstCorridor = boxes.size();
+    segmentCorridor.clear();
+    for(int32 i = 0; i < (int32)MapInfo.Corridors.size(); i++)
+    {
+        const vector<IPoint>& path = MapInfo.Corridors[i]->Path;
+        for(size_t k = 1; k < path.size(); k++)
+        {
+            const IPoint& a = path[k - 1];
+            const IPoint& b = path[k];
+            boxes.push_back(IRect(min(a.X, b.X), min(a.Y, b.Y), abs(b.X - a.X), abs(b.Y - a.Y)));
+            segmentCorridor.push_back(i);
+        }
+    }
+    
+    firstDoor = boxes.size();
+    for(const Door* d : MapInfo.Doors)
+    {
+        boxes.push_back(IRect(d->X, d->Y, 0, 0));
+    }
+    
+    shapes.Build(boxes);
+}
+
+const TileGrid& TileChunks::Chunk(int32 cx, int32 cy)
+{
+    uint64_t key = ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+    if(lastChunk != 0 && key == lastKey)
+    {
+        return *lastChunk;
+    }
+    lastKey = key;
+    
+    auto it = chunks.find(key);
+    if(it != chunks.end())
+    {
+        lastChunk = it->second;
+        return *lastChunk;
+    }
+    
+    // Edges along the chunk border depend on the tiles one step outside it.
+    IRect window(cx * ChunkSize, cy * ChunkSize, ChunkSize, ChunkSize);
+    shapes.Query(IRect(window.Left() - 1, window.Top() - 1, ChunkSize + 1, ChunkSize + 1), found);
+    
+    if(found.empty())
+    {
+        chunks[key] = &empty;
+        lastChunk = &empty;
+        return empty;
+    }
+    
+    // Rasterise only what was found, found is sorted so each list keeps the map's order.
+    nearby.Rooms.clear();
+    nearby.CorridorFeatures.clear();
+    nearby.Corridors.clear();
+    nearby.Doors.clear();
+    for(int32 i : found)
+    {
+        if(i < firstFeature)
+        {
+            nearby.Rooms.push_back(mapInfo->Rooms[i]);
+        }
+        else if(i < firstCorridor)
+        {
+            nearby.CorridorFeatures.push_back(mapInfo->CorridorFeatures[i - firstFeature]);
+        }
+        else if(i < firstDoor)
+        {
+            Corridor* c = mapInfo->Corridors[segmentCorridor[i - firstCorridor]];
+            if(nearby.Corridors.empty() || nearby.Corridors.back() != c)
+            {
+                nearby.Corridors.push_back(c);
+            }
+        }
+        else
+        {
+            nearby.Doors.push_back(mapInfo->Doors[i - firstDoor]);
+        }
+    }
+    
+    TileGrid* chunk = new TileGrid();
+    chunk->Rasterise(nearby, window);
+    chunks[key] = chunk;
+    lastChunk = chunk;
+    materialised++;
+    return *chunk;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "BVH.h"
+#include "TileGrid.h"
+#include "MapModel.h"
+#include "Helper.h"
+
+/**
+ * The tiles of a map split into ChunkSize x ChunkSize TileGrids, each one
+ * rasterised the first time it is asked for.
+ *
+ * Only the rooms, features, corridors and doors a spatial query finds near a
+ * chunk are rasterised into it, and every chunk with nothing near it shares
+ * one empty grid, so memory follows the area the map covers rather than its
+ * bounds. The map must outlive the chunks and not change under them, call
+ * Reset after changing it.
+ */
+class TileChunks
+{
+public:
+    static const int32 ChunkSize = 64;
+    
+    TileChunks() : mapInfo(0), materialised(0), lastKey(0), lastChunk(0) {}
+    TileChunks(const MapInfoType& MapInfo) : mapInfo(0), materialised(0), lastKey(0), lastChunk(0) { Reset(MapInfo); }
+    ~TileChunks() { Clear(); }
+    
+    /** Drop every chunk and index the shapes of MapInfo for later chunks. **/
+    void Reset(const MapInfoType& MapInfo);
+    
+    /** The chunk holding tiles (cx, cy) * ChunkSize onwards, rasterised on first use. **/
+    const TileGrid& Chunk(int32 cx, int32 cy);
+    
+    /** Chunk coordinate of map tile coordinate v, rounding down for negative tiles. **/
+    static int32 ChunkOf(int32 v) { return (v >= 0) ? v / ChunkSize : -((-v + ChunkSize - 1) / ChunkSize); }
+    
+    bool IsFloor(int32 x, int32 y) { return Tile(x, y).IsFloor(x - ChunkOf(x) * ChunkSize, y - ChunkOf(y) * ChunkSize); }
+    bool IsWall(int32 x, int32 y) { return Tile(x, y).IsWall(x - ChunkOf(x) * ChunkSize, y - ChunkOf(y) * ChunkSize); }
+    bool IsDoor(int32 x, int32 y) { return Tile(x, y).IsDoor(x - ChunkOf(x) * ChunkSize, y - ChunkOf(y) * ChunkSize); }
+    WallType Edge(int32 x, int32 y, int32 Side) { return Tile(x, y).Edge(x - ChunkOf(x) * ChunkSize, y - ChunkOf(y) * ChunkSize, Side); }
+    
+    /** Chunks looked up so far, and how many of them needed a grid of their own. **/
+    int32 Chunks() const { return chunks.size(); }
+    int32 Materialised() const { return materialised; }
+    
+private:
+    const MapInfoType* mapInfo;
+    BVH shapes;
+    
+    // What each box in shapes came from, rooms, features, corridors and doors in that order.
+    int32 firstFeature, firstCorridor, firstDoor;
+    std::vector<int32> segmentCorridor;     // Corridor of each corridor segment box.
+    
+    std::unordered_map<uint64_t, TileGrid*> chunks;
+    TileGrid empty;                         // Shared by every chunk with nothing in it.
+    int32 materialised;
+    
+    // Chunk of the last lookup, tiles are usually read a run at a time.
+    uint64_t lastKey;
+    const TileGrid* lastChunk;
+    
+    // Scratch for building chunks.
+    MapInfoType nearby;
+    std::vector<int32> found;
+    
+    const TileGrid& Tile(int32 x, int32 y) { return Chunk(ChunkOf(x), ChunkOf(y)); }
+    void Clear();
+};
\ No newline at end of file
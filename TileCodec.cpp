@@ -0,0 +1,282 @@
+#include "TileCodec.h"
+#include <cstring>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+static void writeVarint(vector<uint8_t>& Out, uint32_t v)
+{
+    while(v >= 0x80)
+    {
+        Out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    Out.push_back((uint8_t)v);
+}
+
+// Read a varint at p, false if it runs past End.
+static inline bool readVarint(const uint8_t*& p, const uint8_t* End, uint32_t& v)
+{
+    // Almost every run fits in one byte.
+    if(p < End && *p < 0x80)
+    {
+        v = *p++;
+        return true;
+    }
+    
+    v = 0;
+    for(int32 shift = 0; p < End && shift < 35; shift += 7)
+    {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if(b < 0x80) return true;
+    }
+    return false;
+}
+
+// First x at or after From whose bit is Value, or Width if there is none.
+static inline int32 nextBit(const uint64_t* Row, int32 Width, int32 From, bool Value)
+{
+    if(From >= Width) return Width;
+    
+    int32 stride = (Width + 63) >> 6;
+    int32 w = From >> 6;
+    uint64_t word = (Value ? Row[w] : ~Row[w]) & (~(uint64_t)0 << (From & 63));
+    while(word == 0)
+    {
+        if(++w >= stride) return Width;
+        word = Value ? Row[w] : ~Row[w];
+    }
+    return min(Width, (w << 6) + LowestBit(word));
+}
+
+// Set bits A to B - 1 of Row.
+static inline void setRange(uint64_t* Row, int32 A, int32 B)
+{
+    if(A >= B) return;
+    
+    int32 first = A >> 6;
+    int32 last = (B - 1) >> 6;
+    uint64_t firstMask = ~(uint64_t)0 << (A & 63);
+    uint64_t lastMask = ~(uint64_t)0 >> (63 - ((B - 1) & 63));
+    if(first == last)
+    {
+        Row[first] |= firstMask & lastMask;
+        return;
+    }
+    
+    Row[first] |= firstMask;
+    for(int32 w = first + 1; w < last; w++)
+    {
+        Row[w] = ~(uint64_t)0;
+    }
+    Row[last] |= lastMask;
+}
+
+// Whether a Width x Height grid is within the limits Encode and Decode both keep to.
+static bool sizeAllowed(int32 Width, int32 Height)
+{
+    if(Width < 0 || Height < 0 || Width > TileCodecMaxSide || Height > TileCodecMaxSide) return false;
+    return (int64_t)Width * Height <= TileCodecMaxTiles;
+}
+
+// Check the header and row table of Data, false if they do not describe a valid encoding.
+static bool readHeader(const uint8_t* Data, size_t Size, TileCodecHeader& Header, const uint32_t*& Offsets, const uint8_t*& Rows)
+{
+    if(Data == 0 || Size < sizeof(TileCodecHeader)) return false;
+    
+    memcpy(&Header, Data, sizeof(Header));
+    if(memcmp(Header.Magic, TileCodecMagic, sizeof(Header.Magic)) != 0 || Header.Version != TileCodecVersion) return false;
+    if(Header.Planes != TilePlaneCount || !sizeAllowed(Header.Width, Header.Height)) return false;
+    
+    size_t table = ((size_t)Header.Height + 1) * sizeof(uint32_t);
+    if(Size - sizeof(TileCodecHeader) < table) return false;
+    
+    Offsets = (const uint32_t*)(Data + sizeof(TileCodecHeader));
+    Rows = Data + sizeof(TileCodecHeader) + table;
+    return Offsets[Header.Height] <= Size - sizeof(TileCodecHeader) - table;
+}
+
+bool TileCodec::Encode(const TileGrid& Tiles, vector<uint8_t>& Out)
+{
+    int32 width = Tiles.Width();
+    int32 height = Tiles.Height();
+    int32 stride = Tiles.Plane(FloorPlane).Stride();
+    Out.clear();
+    if(!sizeAllowed(width, height)) return false;
+    
+    TileCodecHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, TileCodecMagic, sizeof(header.Magic));
+    header.Version = TileCodecVersion;
+    header.OriginX = Tiles.Origin().X;
+    header.OriginY = Tiles.Origin().Y;
+    header.Width = width;
+    header.Height = height;
+    header.Planes = TilePlaneCount;
+    
+    size_t rowsStart = sizeof(header) + ((size_t)height + 1) * sizeof(uint32_t);
+    Out.assign(rowsStart, 0);
+    memcpy(&Out[0], &header, sizeof(header));
+    vector<uint32_t> offsets(height + 1);
+    vector<uint8_t> runs;
+    
+    for(int32 y = 0; y < height; y++)
+    {
+        // Row offsets are 32 bit.
+        if(Out.size() - rowsStart > UINT32_MAX)
+        {
+            Out.clear();
+            return false;
+        }
+        offsets[y] = Out.size() - rowsStart;
+        
+        uint32_t mask = 0;
+        for(int32 p = 0; p < TilePlaneCount; p++)
+        {
+            const uint64_t* row = Tiles.Plane(p).Row(y);
+            for(int32 i = 0; i < stride; i++)
+            {
+                if(row[i] != 0)
+                {
+                    mask |= 1u << p;
+                    break;
+                }
+            }
+        }
+        writeVarint(Out, mask);
+        
+        for(int32 p = 0; p < TilePlaneCount; p++)
+        {
+            if((mask & (1u << p)) == 0) continue;
+            
+            // Alternate 0 and 1 runs, the 0 run to the end of the row is left off.
+            const uint64_t* row = Tiles.Plane(p).Row(y);
+            runs.clear();
+            int32 x = 0;
+            bool value = false;
+            while(x < width)
+            {
+                int32 next = nextBit(row, width, x, !value);
+                if(!value && next == width) break;
+                writeVarint(runs, next - x);
+                x = next;
+                value = !value;
+            }
+            
+            writeVarint(Out, runs.size());
+            Out.insert(Out.end(), runs.begin(), runs.end());
+        }
+    }
+    if(Out.size() - rowsStart > UINT32_MAX)
+    {
+        Out.clear();
+        return false;
+    }
+    offsets[height] = Out.size() - rowsStart;
+    memcpy(&Out[sizeof(header)], &offsets[0], offsets.size() * sizeof(uint32_t));
+    return true;
+}
+
+bool TileCodec::Size(const uint8_t* Data, size_t Size, int32& Width, int32& Height)
+{
+    TileCodecHeader header;
+    const uint32_t* offsets;
+    const uint8_t* rows;
+    if(!readHeader(Data, Size, header, offsets, rows)) return false;
+    
+    Width = header.Width;
+    Height = header.Height;
+    return true;
+}
+
+bool TileCodec::Decode(const uint8_t* Data, size_t Size, TileGrid& Tiles)
+{
+    return Decode(Data, Size, IRect(0, 0, INT_MAX / 2, INT_MAX / 2), Tiles);
+}
+
+bool TileCodec::DecodeRows(const uint8_t* Data, size_t Size, int32 First, int32 Count, TileGrid& Tiles)
+{
+    return Decode(Data, Size, IRect(0, First, INT_MAX / 2, Count), Tiles);
+}
+
+bool TileCodec::Decode(const uint8_t* Data, size_t Size, const IRect& Window, TileGrid& Tiles)
+{
+    TileCodecHeader header;
+    const uint32_t* offsets;
+    const uint8_t* rows;
+    bool valid = readHeader(Data, Size, header, offsets, rows);
+    
+    // Clip the window to the encoded grid.
+    int32 x0 = max(Window.Left(), 0);
+    int32 y0 = max(Window.Top(), 0);
+    int32 x1 = valid ? min(Window.Left() + Window.Width, header.Width) : 0;
+    int32 y1 = valid ? min(Window.Top() + Window.Height, header.Height) : 0;
+    int32 w = max(x1 - x0, 0);
+    int32 h = max(y1 - y0, 0);
+    
+    Tiles.origin = valid ? IPoint(header.OriginX + x0, header.OriginY + y0) : IPoint();
+    for(int32 p = 0; p < TilePlaneCount; p++)
+    {
+        Tiles.planes[p].Resize(w, h);
+    }
+    
+    for(int32 y = 0; valid && y < h; y++)
+    {
+        uint32_t begin = offsets[y0 + y];
+        uint32_t end = offsets[y0 + y + 1];
+        if(begin > end || end > offsets[header.Height])
+        {
+            valid = false;
+            break;
+        }
+        
+        const uint8_t* p = rows + begin;
+        const uint8_t* rowEnd = rows + end;
+        uint32_t mask;
+        valid = readVarint(p, rowEnd, mask);
+        
+        for(int32 plane = 0; valid && plane < TilePlaneCount; plane++)
+        {
+            if((mask & (1u << plane)) == 0) continue;
+            
+            uint32_t length;
+            valid = readVarint(p, rowEnd, length) && (length <= (uint32_t)(rowEnd - p));
+            if(!valid) break;
+            
+            const uint8_t* planeEnd = p + length;
+            uint64_t* row = Tiles.planes[plane].Row(y);
+            int32 x = 0;
+            bool value = false;
+            while(p < planeEnd && x < x1)
+            {
+                uint32_t run;
+                if(!readVarint(p, planeEnd, run) || run > (uint32_t)(header.Width - x))
+                {
+                    valid = false;
+                    break;
+                }
+                if(value)
+                {
+                    setRange(row, max(x, x0) - x0, min(x + (int32)run, x1) - x0);
+                }
+                x += run;
+                value = !value;
+            }
+            
+            // Runs past the window are skipped whole.
+            p = planeEnd;
+        }
+    }
+    
+    if(!valid)
+    {
+        Tiles.origin = IPoint();
+        for(int32 p = 0; p < TilePlaneCount; p++)
+        {
+            Tiles.planes[p].Resize(0, 0);
+        }
+    }
+    return valid;
+}
\ No newline at end of file
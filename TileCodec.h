@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "IRect.h"
+#include "TileGrid.h"
+#include "Helper.h"
+
+/**
+ * Compact encoding of a TileGrid.
+ *
+ * Each row of each plane is stored as alternating runs of 0 and 1 bits,
+ * starting with 0, each run length a LEB128 varint. A row starts with a
+ * varint mask of the planes with any bit set, and each of those planes is
+ * preceded by its byte length, so a decoder can step over planes and rows
+ * without reading their runs. A table of row offsets follows the header, so
+ * any range of rows, or any window such as one chunk, is decoded on its own.
+ *
+ * Runs of set bits are written a word at a time, so decoding costs about one
+ * step per run rather than per tile. Fields are little endian.
+ */
+static const char TileCodecMagic[8] = { 'T', 'I', 'L', 'E', 'R', 'L', 'E', 0 };
+static const uint32_t TileCodecVersion = 1;
+
+/**
+ * Largest grids encoded or decoded. The decoder checks them before any plane is
+ * allocated so a damaged header cannot ask for gigabytes, and at this size the
+ * rows always fit the 32 bit offsets.
+ */
+static const int32 TileCodecMaxSide = 1 << 16;
+static const int64_t TileCodecMaxTiles = (int64_t)1 << 28;
+
+typedef struct
+{
+    char Magic[8];
+    uint32_t Version;
+    int32_t OriginX, OriginY;
+    int32_t Width, Height;
+    int32_t Planes;
+    // Followed by Height + 1 uint32_t row offsets, from the end of the table, then the rows.
+} TileCodecHeader;
+
+class TileCodec
+{
+public:
+    /**
+     * Encode every plane of Tiles, replacing the contents of Out. Returns false, leaving
+     * Out empty, if the grid is over TileCodecMaxSide or TileCodecMaxTiles.
+     */
+    static bool Encode(const TileGrid& Tiles, std::vector<uint8_t>& Out);
+    
+    /** Decode a whole grid. Returns false, leaving Tiles empty, if Data is not a valid encoding. **/
+    static bool Decode(const uint8_t* Data, size_t Size, TileGrid& Tiles);
+    
+    /**
+     * Decode only the tiles inside Window, given in tile coordinates of the encoded
+     * grid and clipped to it. Tiles then holds just that window, its Origin moved to match.
+     */
+    static bool Decode(const uint8_t* Data, size_t Size, const IRect& Window, TileGrid& Tiles);
+    
+    /** Decode rows First to First + Count - 1. **/
+    static bool DecodeRows(const uint8_t* Data, size_t Size, int32 First, int32 Count, TileGrid& Tiles);
+    
+    /** Width and height of the grid held in Data, false if Data is not a valid encoding. **/
+    static bool Size(const uint8_t* Data, size_t Size, int32& Width, int32& Height);
+};
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "TileGrid.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// Set the floor, and room, bits of every shape overlapping the Floor sized area at Origin.
+static void fillShapes(const MapInfoType& MapInfo, const IPoint& Origin, BitGrid& Floor, BitGrid& RoomBits)
+{
+    int32 ox = Origin.X;
+    int32 oy = Origin.Y;
+    
+    for(const Room* r : MapInfo.Rooms)
+    {
+        if(!r->Enabled) continue;
+        
+        const IRect& b = r->Bounds;
+        Floor.Fill(b.Left() - ox, b.Top() - oy, b.Right() - ox, b.Bottom() - oy, true);
+        RoomBits.Fill(b.Left() - ox, b.Top() - oy, b.Right() - ox, b.Bottom() - oy, true);
+    }
+    
+    for(const CorridorFeature* f : MapInfo.CorridorFeatures)
+    {
+        const IRect& b = f->Bounds;
+        Floor.Fill(b.Left() - ox, b.Top() - oy, b.Right() - ox, b.Bottom() - oy, true);
+    }
+    
+    for(const Corridor* c : MapInfo.Corridors)
+    {
+        for(size_t i = 1; i < c->Path.size(); i++)
+        {
+            int32 ax = c->Path[i - 1].X - ox, ay = c->Path[i - 1].Y - oy;
+            int32 bx = c->Path[i].X - ox, by = c->Path[i].Y - oy;
+            int32 dx = bx - ax;
+            int32 dy = by - ay;
+            
+            if(dx == 0 || dy == 0)
+            {
+                Floor.Fill(min(ax, bx), min(ay, by), max(ax, bx), max(ay, by), true);
+                continue;
+            }
+            
+            // Straight corridors that are not axis aligned are stepped along their longer axis.
+            int32 steps = max(abs(dx), abs(dy));
+            for(int32 k = 0; k <= steps; k++)
+            {
+                int32 x = ax + (int32)round((double)dx * k / steps);
+                int32 y = ay + (int32)round((double)dy * k / steps);
+                if(Floor.InBounds(x, y))
+                {
+                    Floor.Set(x, y);
+                }
+            }
+        }
+    }
+}
+
+void TileGrid::Rasterise(const MapInfoType& MapInfo)
+{
+    Rasterise(MapInfo, IRect(0, 0, MapInfo.Width, MapInfo.Height));
+}
+
+void TileGrid::Rasterise(const MapInfoType& MapInfo, const IRect& Window)
+{
+    int32 w = max(Window.Width, 0);
+    int32 h = max(Window.Height, 0);
+    origin = Window.Position;
+    
+    for(int32 p = 0; p < TilePlaneCount; p++)
+    {
+        planes[p].Resize(w, h);
+    }
+    fillShapes(MapInfo, origin, planes[FloorPlane], planes[RoomPlane]);
+    
+    // One tile strips along each side of the window.
+    IPoint borderOrigin[4] = { IPoint(origin.X, origin.Y - 1), IPoint(origin.X + w, origin.Y),
+                               IPoint(origin.X, origin.Y + h), IPoint(origin.X - 1, origin.Y) };
+    for(int32 side = TopWall; side <= LeftWall; side++)
+    {
+        bool across = (side == TopWall || side == BottomWall);
+        borderFloor[side].Resize(across ? w : 1, across ? 1 : h);
+        borderRoom[side].Resize(across ? w : 1, across ? 1 : h);
+        fillShapes(MapInfo, borderOrigin[side], borderFloor[side], borderRoom[side]);
+    }
+    
+    IPoint cornerOrigin[4] = { IPoint(origin.X - 1, origin.Y - 1), IPoint(origin.X + w, origin.Y - 1),
+                               IPoint(origin.X + w, origin.Y + h), IPoint(origin.X - 1, origin.Y + h) };
+    BitGrid cornerBits(1, 1), cornerRoom(1, 1);
+    for(int32 c = 0; c < 4; c++)
+    {
+        cornerBits.Clear();
+        fillShapes(MapInfo, cornerOrigin[c], cornerBits, cornerRoom);
+        cornerFloor[c] = cornerBits.Get(0, 0);
+    }
+    
+    BuildEdges();
+    
+    // A door just outside the window still sets the edge of the tile next to it.
+    for(const Door* d : MapInfo.Doors)
+    {
+        int32 x = d->X - origin.X;
+        int32 y = d->Y - origin.Y;
+        if(x < -1 || y < -1 || x > w || y > h) continue;
+        
+        if(planes[DoorPlane].InBounds(x, y))
+        {
+            planes[DoorPlane].Set(x, y);
+        }
+        SetEdge(x, y, d->Wall, !d->Type.IsOpen, d->Type.IsDestructable);
+    }
+    
+    // Walls are the floor tiles with a blocked edge.
+    for(int32 y = 0; y < h; y++)
+    {
+        uint64_t* wall = planes[WallPlane].Row(y);
+        const uint64_t* floor = planes[FloorPlane].Row(y);
+        const uint64_t* top = planes[BlockedPlane + TopWall].Row(y);
+        const uint64_t* right = planes[BlockedPlane + RightWall].Row(y);
+        const uint64_t* bottom = planes[BlockedPlane + BottomWall].Row(y);
+        const uint64_t* left = planes[BlockedPlane + LeftWall].Row(y);
+        for(int32 i = 0; i < planes[WallPlane].Stride(); i++)
+        {
+            wall[i] = floor[i] & (top[i] | right[i] | bottom[i] | left[i]);
+        }
+    }
+}
+
+// Row at x - 1 lined up with each tile, In being the bit to the left of the row.
+static inline uint64_t fromLeft(const uint64_t* Row, int32 i, uint64_t In)
+{
+    return (Row[i] << 1) | ((i > 0) ? Row[i - 1] >> 63 : In);
+}
+
+// Row at x + 1 lined up with each tile, In being the bit to the right of the row, already at the last tile's bit.
+static inline uint64_t fromRight(const uint64_t* Row, int32 i, int32 Stride, uint64_t In)
+{
+    return (Row[i] >> 1) | ((i + 1 < Stride) ? Row[i + 1] << 63 : In);
+}
+
+void TileGrid::BuildEdges()
+{
+    int32 w = Width();
+    int32 h = Height();
+    int32 stride = planes[FloorPlane].Stride();
+    int32 lastBit = (w - 1) & 63;
+    uint64_t lastMask = ~(uint64_t)0 >> (63 - lastBit);
+    
+    for(int32 y = 0; y < h; y++)
+    {
+        const uint64_t* floor = planes[FloorPlane].Row(y);
+        const uint64_t* room = planes[RoomPlane].Row(y);
+        const uint64_t* floorUp = (y > 0) ? planes[FloorPlane].Row(y - 1) : borderFloor[TopWall].Row(0);
+        const uint64_t* roomUp = (y > 0) ? planes[RoomPlane].Row(y - 1) : borderRoom[TopWall].Row(0);
+        const uint64_t* floorDown = (y + 1 < h) ? planes[FloorPlane].Row(y + 1) : borderFloor[BottomWall].Row(0);
+        const uint64_t* roomDown = (y + 1 < h) ? planes[RoomPlane].Row(y + 1) : borderRoom[BottomWall].Row(0);
+        
+        uint64_t* top = planes[BlockedPlane + TopWall].Row(y);
+        uint64_t* right = planes[BlockedPlane + RightWall].Row(y);
+        uint64_t* bottom = planes[BlockedPlane + BottomWall].Row(y);
+        uint64_t* left = planes[BlockedPlane + LeftWall].Row(y);
+        uint64_t* boundary = planes[BoundaryPlane].Row(y);
+        uint64_t* doorway = planes[DoorwayPlane].Row(y);
+        
+        uint64_t floorLeftIn = borderFloor[LeftWall].Get(0, y);
+        uint64_t roomLeftIn = borderRoom[LeftWall].Get(0, y);
+        uint64_t floorRightIn = (uint64_t)borderFloor[RightWall].Get(0, y) << lastBit;
+        uint64_t roomRightIn = (uint64_t)borderRoom[RightWall].Get(0, y) << lastBit;
+        
+        // Tiles beyond the ends of the rows above and below, from the side strips or the corners.
+        uint64_t upLeftIn = (y > 0) ? borderFloor[LeftWall].Get(0, y - 1) : cornerFloor[0];
+        uint64_t upRightIn = (uint64_t)((y > 0) ? borderFloor[RightWall].Get(0, y - 1) : cornerFloor[1]) << lastBit;
+        uint64_t downRightIn = (uint64_t)((y + 1 < h) ? borderFloor[RightWall].Get(0, y + 1) : cornerFloor[2]) << lastBit;
+        uint64_t downLeftIn = (y + 1 < h) ? borderFloor[LeftWall].Get(0, y + 1) : cornerFloor[3];
+        
+        for(int32 i = 0; i < stride; i++)
+        {
+            uint64_t f = floor[i];
+            uint64_t r = room[i];
+            uint64_t fu = floorUp[i];
+            uint64_t fd = floorDown[i];
+            
+            // Neighbouring tiles to the left and right, shifted into line with each tile.
+            uint64_t fl = fromLeft(floor, i, floorLeftIn);
+            uint64_t rl = fromLeft(room, i, roomLeftIn);
+            uint64_t fr = fromRight(floor, i, stride, floorRightIn);
+            uint64_t rr = fromRight(room, i, stride, roomRightIn);
+            
+            // An edge is blocked where floor meets something else, or a room meets a corridor.
+            top[i] = f & ((f ^ fu) | (r ^ roomUp[i]));
+            bottom[i] = f & ((f ^ fd) | (r ^ roomDown[i]));
+            left[i] = f & ((f ^ fl) | (r ^ rl));
+            right[i] = f & ((f ^ fr) | (r ^ rr));
+            
+            // Solid wall rings the floor, corners included.
+            uint64_t diagonals = fromLeft(floorUp, i, upLeftIn) | fromRight(floorUp, i, stride, upRightIn) |
+                                 fromLeft(floorDown, i, downLeftIn) | fromRight(floorDown, i, stride, downRightIn);
+            uint64_t inRow = (i + 1 < stride) ? ~(uint64_t)0 : lastMask;
+            boundary[i] = ~f & (fu | fd | fl | fr | diagonals) & inRow;
+            
+            // A corridor tile with a room on one side and no floor either side across it.
+            uint64_t corridor = f & ~r;
+            doorway[i] = corridor & (((rl | rr) & ~fu & ~fd) | ((roomUp[i] | roomDown[i]) & ~fl & ~fr));
+        }
+    }
+}
+
+void TileGrid::SetEdge(int32 x, int32 y, int32 Side, bool Blocked, bool Destructable)
+{
+    static const int32 opposite[4] = { BottomWall, LeftWall, TopWall, RightWall };
+    static const int32 stepX[4] = { 0, 1, 0, -1 };
+    static const int32 stepY[4] = { -1, 0, 1, 0 };
+    
+    // Both tiles either side of the edge hold a copy of it.
+    int32 nx = x + stepX[Side];
+    int32 ny = y + stepY[Side];
+    for(int32 k = 0; k < 2; k++)
+    {
+        int32 side = (k == 0) ? Side : opposite[Side];
+        int32 tx = (k == 0) ? x : nx;
+        int32 ty = (k == 0) ? y : ny;
+        if(!planes[FloorPlane].InBounds(tx, ty) || !planes[FloorPlane].Get(tx, ty)) continue;
+        
+        if(Blocked)
+        {
+            planes[BlockedPlane + side].Set(tx, ty);
+        }
+        else
+        {
+            planes[BlockedPlane + side].Reset(tx, ty);
+        }
+        
+        if(Destructable)
+        {
+            planes[DestructablePlane + side].Set(tx, ty);
+        }
+        else
+        {
+            planes[DestructablePlane + side].Reset(tx, ty);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "BitGrid.h"
+#include "IRect.h"
+#include "MapModel.h"
+#include "Helper.h"
+
+/** Bit planes making up a TileGrid, each one a BitGrid over the same tiles. **/
+enum TilePlane
+{
+    FloorPlane,         /** Tile can be stood on, rooms, corridor features and corridors. **/
+    RoomPlane,          /** Tile belongs to a room. **/
+    WallPlane,          /** Floor tile with at least one blocked edge. **/
+    DoorPlane,          /** Floor tile with a door in one of its edges. **/
+    BlockedPlane,       /** First of four planes, one per edge, indexed by TopWall..LeftWall. **/
+    DestructablePlane = BlockedPlane + 4,
+    BoundaryPlane = DestructablePlane + 4,  /** Tile that is not floor next to floor, diagonals included, where solid wall goes. **/
+    DoorwayPlane,       /** Corridor tile one tile wide where it meets a room, a place for a door. **/
+    TilePlaneCount
+};
+
+/**
+ * The finished map as a grid of tiles, one bit per tile in each TilePlane.
+ *
+ * Every plane is stored row major with each row starting on a fresh 64 bit
+ * word, so a plane can be handed on as a single block of words. Each edge
+ * between two tiles is stored on both of them, an edge is blocked where a
+ * floor tile meets one that is not floor, or a room meets a corridor, and
+ * doors open or close the edge they sit in.
+ *
+ * Every plane but the doors is worked out a row of words at a time, each tile's
+ * neighbours brought into line with it by shifting the neighbouring rows.
+ */
+class TileGrid
+{
+public:
+    TileGrid() {}
+    
+    /** Rasterise the whole map, (0, 0) to (Width, Height). **/
+    void Rasterise(const MapInfoType& MapInfo);
+    
+    /**
+     * Rasterise only the Window.Width x Window.Height tiles starting at Window.Position,
+     * which becomes tile (0, 0) of the grid.
+     */
+    void Rasterise(const MapInfoType& MapInfo, const IRect& Window);
+    
+    int32 Width() const { return planes[FloorPlane].Width(); }
+    int32 Height() const { return planes[FloorPlane].Height(); }
+    const IPoint& Origin() const { return origin; }
+    
+    const BitGrid& Plane(int32 Plane) const { return planes[Plane]; }
+    
+    bool IsFloor(int32 x, int32 y) const { return planes[FloorPlane].Get(x, y); }
+    bool IsRoom(int32 x, int32 y) const { return planes[RoomPlane].Get(x, y); }
+    bool IsWall(int32 x, int32 y) const { return planes[WallPlane].Get(x, y); }
+    bool IsDoor(int32 x, int32 y) const { return planes[DoorPlane].Get(x, y); }
+    bool IsBoundary(int32 x, int32 y) const { return planes[BoundaryPlane].Get(x, y); }
+    bool IsDoorway(int32 x, int32 y) const { return planes[DoorwayPlane].Get(x, y); }
+    
+    /** The edge of tile (x, y) on Side, one of TopWall, RightWall, BottomWall or LeftWall. **/
+    WallType Edge(int32 x, int32 y, int32 Side) const
+    {
+        WallType wall = { planes[BlockedPlane + Side].Get(x, y), planes[DestructablePlane + Side].Get(x, y) };
+        return wall;
+    }
+    
+private:
+    friend class TileCodec;
+    
+    IPoint origin;
+    BitGrid planes[TilePlaneCount];
+    
+    // Floor and room bits of the tiles just outside the grid on each side, indexed by
+    // TopWall..LeftWall, so edges along the border match the tiles next to the window.
+    BitGrid borderFloor[4];
+    BitGrid borderRoom[4];
+    
+    // Floor bits of the four tiles diagonally outside the corners, top left then clockwise.
+    bool cornerFloor[4];
+    
+    void BuildEdges();
+    void SetEdge(int32 x, int32 y, int32 Side, bool Blocked, bool Destructable);
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * Hands values from one writer thread to one reader thread without locks.
+ *
+ * Of the three slots the writer owns one, the reader owns one and the third
+ * is the latest published value. Publishing swaps the writer's slot with the
+ * middle one and Update swaps the reader's slot with it, so neither side ever
+ * waits or sees a value while it is being written. Values published faster
+ * than they are read are dropped, the reader always gets the newest.
+ *
+ * Slots are reused, Back() holds whatever was last in the slot, so the writer
+ * should fill in every part of it before each Publish.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : middle(1), back(2), front(0) {}
+    
+    /** The writer's slot, to be filled in before Publish. **/
+    T& Back() { return slots[back]; }
+    
+    /** Make Back() the newest value and hand the writer another slot. **/
+    void Publish()
+    {
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+    
+    /** Take the newest value if one was published since the last call. Returns true if Front() changed. **/
+    bool Update()
+    {
+        if((middle.load(std::memory_order_relaxed) & freshBit) == 0) return false;
+        
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+    
+    /** The reader's slot, unchanged until the next Update. **/
+    const T& Front() const { return slots[front]; }
+    
+private:
+    static const uint32_t indexMask = 3;
+    static const uint32_t freshBit = 4;    // Set in middle when it holds a value the reader has not taken.
+    
+    T slots[3];
+    std::atomic<uint32_t> middle;
+    uint32_t back;      // Only touched by the writer.
+    uint32_t front;     // Only touched by the reader.
+};
\ No newline at end of file
@@ -1,69 +1,219 @@
-#pragma once
-
-class UnionFind
-{
-    int *id, cnt, *sz;
-	
-public:
-    // Create an empty union find data structure with N isolated sets.
-	UnionFind(int N)
-	{
-	    cnt = N;
-		id = new int[N];
-		sz = new int[N];
-		for(int i = 0; i < N; i++)
-		{
-		    id[i] = i;
-			sz[i] = i;
-		}
-	}
-	
-	~UnionFind()
-	{
-	    delete [] id;
-		delete [] sz;
-	}
-	
-	// Return the root id of component corresponding to object p, compress path at same time.
-	int find(int p)
-	{
-	    while(p != id[p])
-		{
-		    id[p] = id[id[p]]; // path compression
-		    p = id[p];
-		}
-		return p;
-	}
-	
-	void link(int X, int Y)
-	{
-	    int i = find(X);
-		int j = find(Y);
-		if(i == j) return;
-		
-		// make smaller root point to larger one
-		if(sz[i] < sz[j]) 
-		{
-		    id[i] = j;
-			sz[j] += sz[i];
-		}
-		else
-		{
-		    id[j] = i;
-			sz[i] += sz[j];
-		}
-		cnt--;
-	}
-	
-	// Are objects x and y in the same set?
-	bool connected(int X, int Y)
-	{
-	    return find(X) == find(Y);
-	}
-	
-	// Return the number of disjoint sets.
-	int count() 
-	{
-	    return cnt;
-	}
-};
\ No newline at end of file
+#pragma once
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+#include <algorithm>
+#include <limits>
+#include "Helper.h"
+
+/**
+ * Union find (disjoint set) with union by size and path halving.
+ *
+ * IndexType sets the width of the stored indices, so small maps can use
+ * uint16_t and keep the whole structure in a few cache lines. N must not
+ * exceed the largest value IndexType can hold.
+ *
+ * Links can be undone. After checkpoint() every link is recorded and
+ * rollback() restores the sets to how they were at that checkpoint, so a
+ * "what if this corridor was added" query costs only the links it made
+ * instead of a rebuild. Path compression is suspended while recording
+ * (union by size alone keeps find at O(log N)), commit() discards the
+ * log and turns it back on.
+ */
+template<typename IndexType = int32>
+class UnionFind
+{
+    std::vector<IndexType> id;
+    std::vector<IndexType> sz;
+    std::vector<IndexType> history; // Roots linked since the first checkpoint, oldest first.
+    int32 cnt;
+    bool recording;
+    
+public:
+    // Create an empty union find data structure with N isolated sets.
+    UnionFind(int32 N) : id(N), sz(N, 1), cnt(N), recording(false)
+    {
+        for(int32 i = 0; i < N; i++)
+        {
+            id[i] = (IndexType)i;
+        }
+    }
+    
+    // Largest number of objects this index width can address.
+    static int64_t capacity()
+    {
+        return (int64_t)std::numeric_limits<IndexType>::max();
+    }
+    
+    // Return the root id of component corresponding to object p, compress path at same time.
+    int32 find(int32 p)
+    {
+        while(p != id[p])
+        {
+            if(!recording)
+            {
+                id[p] = id[id[p]]; // path compression
+            }
+            p = id[p];
+        }
+        return p;
+    }
+    
+    // Join the sets containing X and Y. Returns false if they were already joined.
+    bool link(int32 X, int32 Y)
+    {
+        int32 i = find(X);
+        int32 j = find(Y);
+        if(i == j) return false;
+        
+        // make smaller root point to larger one
+        if(sz[i] < sz[j]) std::swap(i, j);
+        
+        id[j] = (IndexType)i;
+        sz[i] += sz[j];
+        cnt--;
+        
+        if(recording)
+        {
+            history.push_back((IndexType)j);
+        }
+        return true;
+    }
+    
+    // Are objects x and y in the same set?
+    bool connected(int32 X, int32 Y)
+    {
+        return find(X) == find(Y);
+    }
+    
+    // Return the number of disjoint sets.
+    int32 count() const
+    {
+        return cnt;
+    }
+    
+    // Return the number of objects in the set containing p.
+    int32 size(int32 p)
+    {
+        return sz[find(p)];
+    }
+    
+    // Start recording links, the returned mark can be passed to rollback.
+    int32 checkpoint()
+    {
+        recording = true;
+        return history.size();
+    }
+    
+    // Undo every link made after the checkpoint that returned mark, newest first.
+    void rollback(int32 mark)
+    {
+        while((int32)history.size() > mark)
+        {
+            IndexType j = history.back();
+            history.pop_back();
+            
+            IndexType i = id[j];
+            sz[i] -= sz[j];
+            id[j] = j;
+            cnt++;
+        }
+    }
+    
+    // Keep every recorded link, forget the log and resume path compression.
+    void commit()
+    {
+        history.clear();
+        recording = false;
+    }
+};
+
+typedef UnionFind<uint16_t> SmallUnionFind;
+
+
+/**
+ * Union find that can be shared between threads without locking.
+ * Roots are linked with a compare and swap, so concurrent link calls on
+ * overlapping sets are safe. Roots are linked in a fixed pseudo random
+ * priority order so trees stay shallow regardless of the order in which
+ * threads perform their links.
+ */
+class ConcurrentUnionFind
+{
+    std::vector<std::atomic<int32> > id;
+    
+    static uint32_t priority(int32 p)
+    {
+        uint32_t h = (uint32_t)p * 0x9E3779B1u;
+        return h ^ (h >> 16);
+    }
+    
+    // Returns true if root p should be placed below root q.
+    static bool below(int32 p, int32 q)
+    {
+        uint32_t a = priority(p);
+        uint32_t b = priority(q);
+        return (a < b) || (a == b && p < q);
+    }
+    
+public:
+    ConcurrentUnionFind(int32 N) : id(N)
+    {
+        for(int32 i = 0; i < N; i++)
+        {
+            id[i].store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    // Return the root id of component corresponding to object p, halving the path as it goes.
+    int32 find(int32 p)
+    {
+        int32 parent = id[p].load(std::memory_order_acquire);
+        while(p != parent)
+        {
+            int32 grand = id[parent].load(std::memory_order_acquire);
+            if(parent != grand)
+            {
+                // Path halving, losing the race here only means less compression.
+                id[p].compare_exchange_weak(parent, grand, std::memory_order_acq_rel);
+            }
+            p = grand;
+            parent = id[p].load(std::memory_order_acquire);
+        }
+        return p;
+    }
+    
+    // Join the sets containing X and Y. Returns false if they were already joined.
+    bool link(int32 X, int32 Y)
+    {
+        while(true)
+        {
+            int32 i = find(X);
+            int32 j = find(Y);
+            if(i == j) return false;
+            
+            if(below(j, i)) std::swap(i, j);
+            
+            // i must still be a root for the link to be valid, retry if another thread moved it.
+            int32 expected = i;
+            if(id[i].compare_exchange_strong(expected, j, std::memory_order_acq_rel))
+            {
+                return true;
+            }
+        }
+    }
+    
+    // Are objects X and Y in the same set?
+    bool connected(int32 X, int32 Y)
+    {
+        while(true)
+        {
+            int32 i = find(X);
+            int32 j = find(Y);
+            if(i == j) return true;
+            
+            // Only report disjoint if i is still a root, otherwise it may have been linked to j meanwhile.
+            if(id[i].load(std::memory_order_acquire) == i) return false;
+        }
+    }
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include "Helper.h"
+
+/**
+ * Weighted sampling without replacement over a fixed set of items.
+ *
+ * Weights are kept in a Fenwick (binary indexed) tree so drawing an item and
+ * removing it from the pool both take O(log N). Building the tree is O(N).
+ *
+ * Items with a weight of zero are never drawn.
+ */
+class WeightedSampler
+{
+    std::vector<double> tree;    // 1 based Fenwick tree of partial sums.
+    std::vector<double> weight;
+    int32 remaining;
+    int32 topBit;
+    
+public:
+    WeightedSampler(const std::vector<double>& Weights) : tree(Weights.size() + 1, 0.0), weight(Weights), remaining(0)
+    {
+        int32 n = Weights.size();
+        for(int32 i = 0; i < n; i++)
+        {
+            if(weight[i] > 0.0)
+            {
+                tree[i + 1] += weight[i];
+                remaining++;
+            }
+            else
+            {
+                weight[i] = 0.0;
+            }
+            
+            // Linear time build, each node pushes its sum to its parent.
+            int32 parent = (i + 1) + ((i + 1) & -(i + 1));
+            if(parent <= n) tree[parent] += tree[i + 1];
+        }
+        
+        topBit = 1;
+        while((topBit << 1) <= n) topBit <<= 1;
+    }
+    
+    // Number of items that can still be drawn.
+    int32 count() const { return remaining; }
+    
+    double total() const
+    {
+        double sum = 0.0;
+        for(int32 i = weight.size(); i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+    
+    /**
+     * Draw an item with probability proportional to its weight and remove it.
+     * u is a uniform random number in [0, 1). Returns -1 when nothing is left.
+     */
+    int32 draw(double u)
+    {
+        if(remaining == 0) return -1;
+        
+        // Walk down the implicit tree to the item whose prefix sum covers target.
+        double target = u * total();
+        int32 n = weight.size();
+        int32 pos = 0;
+        for(int32 step = topBit; step > 0; step >>= 1)
+        {
+            int32 next = pos + step;
+            if(next <= n && tree[next] <= target)
+            {
+                pos = next;
+                target -= tree[next];
+            }
+        }
+        
+        // Rounding in the sums can land on an exhausted item, move to the nearest live one.
+        int32 index = (pos < n) ? pos : n - 1;
+        while(index > 0 && weight[index] == 0.0) index--;
+        while(index < n && weight[index] == 0.0) index++;
+        
+        remove(index);
+        return index;
+    }
+    
+    // Take an item out of the pool.
+    void remove(int32 index)
+    {
+        double w = weight[index];
+        if(w == 0.0) return;
+        
+        weight[index] = 0.0;
+        remaining--;
+        
+        int32 n = weight.size();
+        for(int32 i = index + 1; i <= n; i += i & -i) tree[i] -= w;
+    }
+};
\ No newline at end of file
@@ -18,14 +18,22 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
 
 // Here is a small helper for you ! Have a look.
 #include "ResourcePath.hpp"
 #include "MapModel.h"
+#include "MapColours.h"
 #include "RoomFilter.h"
 #include "MapBuilderLib.h"
 #include "PseudoRand.h"
 #include "Delaunay.h"
+#include "MapVertices.h"
+#include "TripleBuffer.h"
 
 using namespace std;
 
@@ -40,254 +48,357 @@ using namespace std;
 
 static int WinWidth = 800;
 static int WinHeight = 800;
-static int mode = 0;
+static int mode = 0;    // Stage of the pipeline, only touched by the generation thread.
 
+// Tiles to pixels at the starting zoom, the view zooms and pans from there.
 static int scaleFactor = 1;
 
+// Past this many rooms on screen the view draws the density squares in place of the map.
+static const int64_t MaxDetailRooms = 20000;
+static const float ZoomStep = 1.25f;
+
 static int roomCount = 0;
 static vector<RoomFilter*> filters;
 static list<int32> edges;
 
-static sf::Color RoomFillColor = sf::Color::White;
-static sf::Color RoomLineColor = sf::Color::Red;
-static sf::Color CorridorFillColor = sf::Color::White;
-static sf::Color CorridorLineColor = sf::Color::Blue;
-static sf::Color DelaunayLineColor = sf::Color::Yellow;
-static sf::Color FinalEdgeLineColor = sf::Color::Cyan;
+// One stage step a frame, so the stages can be watched as they happen.
+static const chrono::microseconds FramePeriod(1000000 / 60);
+
+static sf::Color toColor(const MapColour& c) { return sf::Color(c.R, c.G, c.B, c.A); }
 
-void drawMinSpan(sf::RenderWindow& rw, list<int32>& minSpan, vector<FPoint*>& point)
+/** The pipeline as the window draws it, rebuilt whole by the generation thread each time it changes. **/
+class MapSnapshot
 {
-    sf::Vertex line[] =
-    {
-        sf::Vertex(sf::Vector2f(0,0), FinalEdgeLineColor),
-        sf::Vertex(sf::Vector2f(0,0), FinalEdgeLineColor)
-    };
-    
-    auto end = minSpan.end();
-    for(auto itr = minSpan.begin(); itr != end; itr++)
-    {
-        FPoint* v1 = point[*itr];
-        itr++;
-        FPoint* v2 = point[*itr];
-        
-        line[0].position.x = v1->X * scaleFactor;
-        line[0].position.y = v1->Y * scaleFactor;
-        line[1].position.x = v2->X * scaleFactor;
-        line[1].position.y = v2->Y * scaleFactor;
-        rw.draw(line, 2, sf::Lines);
-    }
+public:
+    MapSnapshot() : Stage(-1), Rooms(0) {}
     
-}
+    int Stage;
+    int32 Rooms;
+    MapVertexBuilder Vertices;
+};
 
-void drawRoomPoints(sf::RenderWindow& rw, vector<FPoint*>& point)
+static TripleBuffer<MapSnapshot> snapshots;
+static atomic<bool> running(true);
+static vector<sf::Vertex> layers[MapLayerCount];     // The items of each layer inside the view.
+static vector<int32> visibleRooms;
+static vector<int32> visibleItems;
+
+static sf::View view;
+static float zoomLevel = 1.f;   // Map pixels per window pixel.
+static bool viewChanged = true;
+static bool dragging = false;
+static sf::Vector2i dragFrom;
+
+// Hand the window the layers the current stage shows.
+void publish(Triangulation* tri, list<int32>* minSpan)
 {
-    sf::CircleShape circle(6);
-    circle.setFillColor(sf::Color::Green);
-    circle.setOrigin(3.f, 3.f);
+    MapSnapshot& snapshot = snapshots.Back();
+    MapVertexBuilder& vertices = snapshot.Vertices;
+    snapshot.Stage = mode;
+    snapshot.Rooms = MapInfo.Rooms.size();
     
-    int len = point.size();
-    for(int i = 0; i < len; i++)
+    vertices.SetScale((float)scaleFactor);
+    vertices.ClearAll();
+    vertices.BuildRooms(MapInfo);
+    if(mode >= FILTER_CORRIDOR_FEATURES)
     {
-        circle.setPosition(point[i]->X * scaleFactor, point[i]->Y * scaleFactor);
-        rw.draw(circle);
+        vertices.BuildCorridorFeatures(MapInfo);
     }
-}
-
-void drawDelaunayEdge(sf::RenderWindow& rw, vector<Edge*>& edge, vector<FPoint*>& point)
-{
-    sf::Vertex line[] =
+    if(mode > CALC_CONNECTIONS && mode <= DELAUNAY_DRAW_DELAY)
     {
-        sf::Vertex(sf::Vector2f(0,0), DelaunayLineColor),
-        sf::Vertex(sf::Vector2f(0,0), DelaunayLineColor)
-    };
-    
-    int len = edge.size();
-    for(int i = 0; i < len; i++)
+        vertices.BuildDelaunay(*tri);
+    }
+    if(mode > DELAUNAY_DRAW_DELAY && mode <= BUILD_CORRIDORS)
     {
-        FPoint* v1 = point[edge[i]->s];
-        FPoint* v2 = point[edge[i]->t];
-        
-        line[0].position.x = v1->X * scaleFactor;
-        line[0].position.y = v1->Y * scaleFactor;
-        line[1].position.x = v2->X * scaleFactor;
-        line[1].position.y = v2->Y * scaleFactor;
-        rw.draw(line, 2, sf::Lines);
+        vertices.BuildMinSpan(*minSpan, tri->point);
+    }
+    if(mode > BUILD_CORRIDORS)
+    {
+        vertices.BuildCorridors(MapInfo);
     }
+    snapshots.Publish();
 }
 
-void drawFilters(sf::RenderWindow& rw)
+// The whole pipeline, off the render loop so a slow stage never stalls the window.
+void runPipeline()
 {
-    for(auto f: filters)
+    Triangulation* tri = nullptr;
+    list<int32>* minSpan = nullptr;
+    int delayCount = 120;
+    int revealed = 0;
+    int publishedMode = -1;
+    
+    while(running && mode <= BUILD_CORRIDORS)
     {
-        f->DrawFilter(rw, scaleFactor);
+        chrono::steady_clock::time_point next = chrono::steady_clock::now() + FramePeriod;
+        
+        if(mode == BUILD_CORRIDORS)
+        {
+            UMapBuilderLib::GenerateCorridors(MapInfo, *minSpan, AStarRouting);
+            UMapBuilderLib::PlaceDoors(MapInfo);
+            UMapBuilderLib::LinkCorridorFeatures(MapInfo);
+            cout << "                        #Doors=" << MapInfo.Doors.size() << "\n";
+            mode++;
+        }
+        
+        if(mode == DELAUNAY_DRAW_DELAY)
+        {
+            if(--delayCount < 1)
+            {
+                mode++;
+            }
+        }
+        
+        if(mode == CALC_CONNECTIONS)
+        {
+            tri = UMapBuilderLib::PerformDelaunayTriangulation(MapInfo);
+            cout << "After triangulation #totalEdges=" << tri->edge.size() << "\n";
+            
+            minSpan = UMapBuilderLib::CalcMinSpan(MapInfo, *tri);
+            cout << "After Kruskal #totalEdges=" << tri->edge.size() << "\n";
+            cout << "                #minEdges=" << (minSpan->size()/2) << "\n";
+            
+            UMapBuilderLib::AddRandomEdges(MapInfo, *tri, *minSpan);
+            cout << "After random insertion #totalEdges=" << tri->edge.size() << "\n";
+            cout << "                         #minEdges=" << (minSpan->size()/2) << "\n";
+            mode++;
+        }
+        
+        if(mode == REDUCE_ROOMS)
+        {
+            UMapBuilderLib::ReduceRooms(MapInfo);
+            cout << "After room reduction #rooms=" << MapInfo.Rooms.size() << "\n";
+            mode++;
+        }
+        
+        if(mode == FILTER_CORRIDOR_FEATURES)
+        {
+            UMapBuilderLib::SeparateCorridorFeatures(MapInfo);
+            cout << "After separating corridor features #rooms=" << MapInfo.Rooms.size() << "\n";
+            cout << "                        #CorridorFeatures=" << MapInfo.CorridorFeatures.size() << "\n";
+            mode++;
+        }
+        
+        if(mode == FILTER_ROOMS)
+        {
+            if(filters.size() > 0)
+            {
+                for(auto f : filters)
+                {
+                    UMapBuilderLib::FilterRooms(MapInfo, *f);
+                }
+                UMapBuilderLib::RemoveFiltered(MapInfo);
+            }
+            cout << "After filtering #rooms=" << MapInfo.Rooms.size() << "\n";
+            mode++;
+        }
+        
+        if(mode == SEPARATE_ROOMS)
+        {
+            if(UMapBuilderLib::SeparateRooms(MapInfo))
+            {
+                mode++;
+            }
+        }
+        
+        if(mode == REMOVE_ON_RATIO)
+        {
+            UMapBuilderLib::RemoveRoomsBelowRatio(MapInfo, (1.f / 3.f));
+            cout << "After ratio reduction #rooms=" << MapInfo.Rooms.size() << "\n";
+            mode++;
+        }
+        
+        // The window reveals the rooms one a frame before anything is done to them.
+        if(mode == 0 && ++revealed >= (int)MapInfo.Rooms.size())
+        {
+            mode++;
+        }
+        
+        // Rooms move every step while they are pushed apart, otherwise only a change of stage changes the picture.
+        if(mode != publishedMode || mode == SEPARATE_ROOMS)
+        {
+            publish(tri, minSpan);
+            publishedMode = mode;
+        }
+        this_thread::sleep_until(next);
     }
+    
+    delete tri;
+    delete minSpan;
 }
 
-void drawCorridor(sf::RenderWindow& rw, Corridor* c)
+// Rooms of the snapshot inside area, going by how much of the rooms' extent area covers.
+int64_t expectedRooms(const MapSnapshot& snapshot, const IRect& area)
 {
-    sf::Vertex line[] =
-    {
-        sf::Vertex(sf::Vector2f(0,0), CorridorLineColor),
-        sf::Vertex(sf::Vector2f(0,0), CorridorLineColor)
-    };
-    line[0].position.x = c->SX;
-    line[0].position.y = c->SY;
-    line[1].position.x = c->EX;
-    line[1].position.y = c->EY;
-    rw.draw(line, 2, sf::Lines);
+    const IRect& extent = snapshot.Vertices.Extent();
+    if(extent.Width <= 0 || extent.Height <= 0) return 0;
+    
+    int64_t w = min(area.Right(), extent.Right()) - max(area.Left(), extent.Left());
+    int64_t h = min(area.Bottom(), extent.Bottom()) - max(area.Top(), extent.Top());
+    if(w <= 0 || h <= 0) return 0;
+    
+    return snapshot.Rooms * w * h / ((int64_t)extent.Width * extent.Height);
 }
 
-void drawCorridors(sf::RenderWindow& rw)
+// Copy the items of a layer the index finds in area into SFML's vertex format.
+void cullLayer(const MapSnapshot& snapshot, MapLayer layer, const IRect& area, vector<int32>& items)
 {
-    int len = MapInfo.Corridors.size();
-    for(int i = 0; i < len; i++)
+    const vector<MapVertex>& src = snapshot.Vertices.Layer(layer);
+    vector<sf::Vertex>& dst = layers[layer];
+    int32 n = MapVertexBuilder::ItemVertices(layer);
+    
+    snapshot.Vertices.Query(layer, area, items);
+    dst.resize(items.size() * n);
+    for(size_t i = 0; i < items.size(); i++)
     {
-        drawCorridor(rw, MapInfo.Corridors[i]);
+        const MapVertex* v = &src[(size_t)items[i] * n];
+        for(int32 k = 0; k < n; k++)
+        {
+            dst[i * n + k] = sf::Vertex(sf::Vector2f(v[k].X, v[k].Y), toColor(v[k].Colour));
+        }
     }
 }
 
-void drawRoom(sf::RenderWindow& rw, IRect& rect)
+// Gather what the view shows, once per change of view or snapshot rather than per frame.
+void cullLayers(const MapSnapshot& snapshot)
 {
-    sf::RectangleShape room(sf::Vector2f(rect.Width * scaleFactor, rect.Height * scaleFactor));
-    
-    int32 x1 = rect.Position.X * scaleFactor;
-    int32 y1 = rect.Position.Y * scaleFactor;
-    int32 x2 = x1 + (rect.Width * scaleFactor);
-    int32 y2 = y1 + (rect.Height * scaleFactor);
+    sf::Vector2f centre = view.getCenter();
+    sf::Vector2f size = view.getSize();
+    int32 left = (int32)floor(centre.x - size.x / 2);
+    int32 top = (int32)floor(centre.y - size.y / 2);
+    IRect area(left, top, (int32)ceil(centre.x + size.x / 2) - left, (int32)ceil(centre.y + size.y / 2) - top);
     
-    room.setFillColor(RoomFillColor);
-    room.setPosition(x1, y1);
-    rw.draw(room);
+    for(int i = 0; i < MapLayerCount; i++)
+    {
+        layers[i].clear();
+    }
+    visibleRooms.clear();
     
-    // Draw cell lines
-    sf::Vertex line[] =
+    if(expectedRooms(snapshot, area) > MaxDetailRooms)
     {
-        sf::Vertex(sf::Vector2f(0,0), RoomLineColor),
-        sf::Vertex(sf::Vector2f(0,0), RoomLineColor)
-    };
+        cullLayer(snapshot, DensityLayer, area, visibleItems);
+        return;
+    }
     
-    line[0].position.x = x1;
-    line[0].position.y = y1;
-    line[1].position.x = x2;
-    line[1].position.y = y1;
-    rw.draw(line, 2, sf::Lines);
-    line[1].position.x = x1;
-    line[1].position.y = y2;
-    rw.draw(line, 2, sf::Lines);
-    line[0].position.x = x2;
-    line[0].position.y = y2;
-    rw.draw(line, 2, sf::Lines);
-    line[1].position.x = x2;
-    line[1].position.y = y1;
-    rw.draw(line, 2, sf::Lines);
-    // Draw horizonal lines.
-    /*for(int y = y1; y <= y2; y += scaleFactor)
-     {
-     line[0].position.x = x1;
-     line[0].position.y = y;
-     line[1].position.x = x2;
-     line[1].position.y = y;
-     rw.draw(line, 2, sf::Lines);
-     }
-     // Draw vertical lines.
-     for(int x = x1; x <= x2; x += scaleFactor)
-     {
-     line[0].position.x = x;
-     line[0].position.y = y1;
-     line[1].position.x = x;
-     line[1].position.y = y2;
-     rw.draw(line, 2, sf::Lines);
-     }*/
+    cullLayer(snapshot, RoomFillLayer, area, visibleRooms);
+    cullLayer(snapshot, RoomLineLayer, area, visibleRooms);
+    for(int i = FeatureFillLayer; i < DensityLayer; i++)
+    {
+        cullLayer(snapshot, (MapLayer)i, area, visibleItems);
+    }
 }
 
-void drawRooms(sf::RenderWindow& rw)
+// Zoom by factor keeping the map point under pixel (x, y) where it is.
+void zoomAt(const sf::RenderWindow& rw, int x, int y, float factor)
 {
-    
-    for(int i = 0; i < roomCount; i++)
+    sf::Vector2f before = rw.mapPixelToCoords(sf::Vector2i(x, y), view);
+    view.zoom(factor);
+    zoomLevel *= factor;
+    sf::Vector2f after = rw.mapPixelToCoords(sf::Vector2i(x, y), view);
+    view.move(before.x - after.x, before.y - after.y);
+    viewChanged = true;
+}
+
+// Pan by a share of the view's size.
+void panBy(float dx, float dy)
+{
+    view.move(view.getSize().x * dx, view.getSize().y * dy);
+    viewChanged = true;
+}
+
+void handleViewEvent(const sf::RenderWindow& rw, const sf::Event& event)
+{
+    if(event.type == sf::Event::MouseWheelScrolled)
     {
-        drawRoom(rw, MapInfo.Rooms[i]->Bounds);
+        zoomAt(rw, event.mouseWheelScroll.x, event.mouseWheelScroll.y, event.mouseWheelScroll.delta > 0 ? 1.f / ZoomStep : ZoomStep);
     }
-    
-    if(roomCount < MapInfo.Rooms.size())
+    else if(event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left)
     {
-        roomCount++;
-        if(roomCount == MapInfo.Rooms.size())
+        dragging = true;
+        dragFrom = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+    }
+    else if(event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left)
+    {
+        dragging = false;
+    }
+    else if(event.type == sf::Event::MouseMoved && dragging)
+    {
+        sf::Vector2i to(event.mouseMove.x, event.mouseMove.y);
+        sf::Vector2f a = rw.mapPixelToCoords(dragFrom, view);
+        sf::Vector2f b = rw.mapPixelToCoords(to, view);
+        view.move(a.x - b.x, a.y - b.y);
+        dragFrom = to;
+        viewChanged = true;
+    }
+    else if(event.type == sf::Event::Resized)
+    {
+        // Keep the zoom, show more or less of the map rather than stretching it.
+        view.setSize(event.size.width * zoomLevel, event.size.height * zoomLevel);
+        viewChanged = true;
+    }
+    else if(event.type == sf::Event::KeyPressed)
+    {
+        sf::Vector2u size = rw.getSize();
+        switch(event.key.code)
         {
-            mode++;
+            case sf::Keyboard::Left: panBy(-0.1f, 0.f); break;
+            case sf::Keyboard::Right: panBy(0.1f, 0.f); break;
+            case sf::Keyboard::Up: panBy(0.f, -0.1f); break;
+            case sf::Keyboard::Down: panBy(0.f, 0.1f); break;
+            case sf::Keyboard::Add:
+            case sf::Keyboard::Equal: zoomAt(rw, size.x / 2, size.y / 2, 1.f / ZoomStep); break;
+            case sf::Keyboard::Subtract:
+            case sf::Keyboard::Dash: zoomAt(rw, size.x / 2, size.y / 2, ZoomStep); break;
+            case sf::Keyboard::Home:
+                view = sf::View(sf::Vector2f(WinWidth / 2.f, WinHeight / 2.f), sf::Vector2f((float)size.x, (float)size.y));
+                zoomLevel = 1.f;
+                viewChanged = true;
+                break;
+            default: break;
         }
     }
 }
 
-void drawCorridorFeature(sf::RenderWindow& rw, IRect& rect)
+// Draw the first count vertices of a layer in one call.
+void drawLayer(sf::RenderWindow& rw, MapLayer layer, size_t count)
 {
-    sf::RectangleShape room(sf::Vector2f(rect.Width * scaleFactor, rect.Height * scaleFactor));
-    
-    int32 x1 = rect.Position.X * scaleFactor;
-    int32 y1 = rect.Position.Y * scaleFactor;
-    int32 x2 = x1 + (rect.Width * scaleFactor);
-    int32 y2 = y1 + (rect.Height * scaleFactor);
+    count = min(count, layers[layer].size());
+    if(count == 0) return;
     
-    room.setFillColor(CorridorFillColor);
-    room.setPosition(x1, y1);
-    rw.draw(room);
-    
-    // Draw cell lines
-    sf::Vertex line[] =
+    rw.draw(&layers[layer][0], count, MapVertexBuilder::IsTriangles(layer) ? sf::Triangles : sf::Lines);
+}
+
+void drawLayer(sf::RenderWindow& rw, MapLayer layer)
+{
+    drawLayer(rw, layer, layers[layer].size());
+}
+
+void drawFilters(sf::RenderWindow& rw)
+{
+    for(auto f: filters)
     {
-        sf::Vertex(sf::Vector2f(0,0), CorridorLineColor),
-        sf::Vertex(sf::Vector2f(0,0), CorridorLineColor)
-    };
-    
-    line[0].position.x = x1;
-    line[0].position.y = y1;
-    line[1].position.x = x2;
-    line[1].position.y = y1;
-    rw.draw(line, 2, sf::Lines);
-    line[1].position.x = x1;
-    line[1].position.y = y2;
-    rw.draw(line, 2, sf::Lines);
-    line[0].position.x = x2;
-    line[0].position.y = y2;
-    rw.draw(line, 2, sf::Lines);
-    line[1].position.x = x2;
-    line[1].position.y = y1;
-    rw.draw(line, 2, sf::Lines);
-    /*
-     // Draw horizonal lines.
-     for(int y = y1; y <= y2; y += scaleFactor)
-     {
-     line[0].position.x = x1;
-     line[0].position.y = y;
-     line[1].position.x = x2;
-     line[1].position.y = y;
-     rw.draw(line, 2, sf::Lines);
-     }
-     // Draw vertical lines.
-     for(int x = x1; x <= x2; x += scaleFactor)
-     {
-     line[0].position.x = x;
-     line[0].position.y = y1;
-     line[1].position.x = x;
-     line[1].position.y = y2;
-     rw.draw(line, 2, sf::Lines);
-     }*/
+        f->DrawFilter(rw, scaleFactor);
+    }
 }
 
-void drawCorridorFeatures(sf::RenderWindow& rw)
+void drawRooms(sf::RenderWindow& rw, const MapSnapshot& snapshot)
 {
-    int len = MapInfo.CorridorFeatures.size();
-    for(int i = 0; i < len; i++)
+    // Rooms appear one a frame, the first roomCount of them. The visible ones are in order, so those are the front of each layer.
+    if(snapshot.Stage > 0)
+    {
+        roomCount = snapshot.Rooms;
+    }
+    else if(roomCount < snapshot.Rooms)
     {
-        drawCorridorFeature(rw, MapInfo.CorridorFeatures[i]->Bounds);
+        roomCount++;
     }
+    size_t shown = lower_bound(visibleRooms.begin(), visibleRooms.end(), roomCount) - visibleRooms.begin();
+    drawLayer(rw, RoomFillLayer, shown * MapVertexBuilder::BoxFillVertices);
+    drawLayer(rw, RoomLineLayer, shown * MapVertexBuilder::BoxLineVertices);
 }
 
 int main(int, char const**)
 {
-    Triangulation* tri;
-    list<int32>* minSpan;
-    int delayCount = 120;
-    
     // Create the main window
     sf::RenderWindow window(sf::VideoMode(WinWidth, WinHeight), "SFML window");
     
@@ -315,6 +426,10 @@ int main(int, char const**)
     cout << "After room generation #rooms=" << MapInfo.Rooms.size() << "\n";
     
     window.setFramerateLimit(60);
+    view = window.getDefaultView();
+    
+    // From here MapInfo belongs to the generation thread, the window only sees its snapshots.
+    thread generator(runPipeline);
     
     // Start the game loop
     while (window.isOpen())
@@ -332,118 +447,44 @@ int main(int, char const**)
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
                 window.close();
             }
+            
+            // Wheel or +/- zooms, dragging or the arrow keys pan, Home goes back to the whole map.
+            handleViewEvent(window, event);
         }
         
         // Clear screen
         window.clear();
         
-        if(mode == BUILD_CORRIDORS)
+        if(snapshots.Update() || viewChanged)
         {
-            UMapBuilderLib::GenerateCorridors(MapInfo, *minSpan);
-            mode++;
+            cullLayers(snapshots.Front());
+            viewChanged = false;
         }
+        const MapSnapshot& snapshot = snapshots.Front();
         
-        if(mode == DELAUNAY_DRAW_DELAY)
-        {
-            if(--delayCount < 1)
-            {
-                mode++;
-            }
-        }
+        window.setView(view);
+        drawLayer(window, DensityLayer);
+        drawRooms(window, snapshot);
         
-        if(mode == CALC_CONNECTIONS)
-        {
-            tri = UMapBuilderLib::PerformDelaunayTriangulation(MapInfo);
-            cout << "After triangulation #totalEdges=" << tri->edge.size() << "\n";
-            
-            minSpan = UMapBuilderLib::CalcMinSpan(MapInfo, *tri);
-            cout << "After Kruskal #totalEdges=" << tri->edge.size() << "\n";
-            cout << "                #minEdges=" << (minSpan->size()/2) << "\n";
-            
-            UMapBuilderLib::AddRandomEdges(MapInfo, *tri, *minSpan);
-            cout << "After random insertion #totalEdges=" << tri->edge.size() << "\n";
-            cout << "                         #minEdges=" << (minSpan->size()/2) << "\n";
-            mode++;
-        }
-        
-        if(mode == REDUCE_ROOMS)
-        {
-            UMapBuilderLib::ReduceRooms(MapInfo);
-            roomCount = MapInfo.Rooms.size();
-            cout << "After room reduction #rooms=" << MapInfo.Rooms.size() << "\n";
-            mode++;
-        }
-        
-        if(mode == FILTER_CORRIDOR_FEATURES)
-        {
-            UMapBuilderLib::SeparateCorridorFeatures(MapInfo);
-            roomCount = MapInfo.Rooms.size();
-            cout << "After separating corridor features #rooms=" << MapInfo.Rooms.size() << "\n";
-            cout << "                        #CorridorFeatures=" << MapInfo.CorridorFeatures.size() << "\n";
-            mode++;
-        }
-        
-        if(mode == FILTER_ROOMS)
-        {
-            if(filters.size() > 0)
-            {
-                for(auto f : filters)
-                {
-                    UMapBuilderLib::FilterRooms(MapInfo, *f);
-                }
-                UMapBuilderLib::RemoveFiltered(MapInfo);
-            }
-            roomCount = MapInfo.Rooms.size();
-            cout << "After filtering #rooms=" << MapInfo.Rooms.size() << "\n";
-            mode++;
-        }
-        
-        if(mode == SEPARATE_ROOMS)
-        {
-            if(UMapBuilderLib::SeparateRooms(MapInfo))
-            {
-                mode++;
-            }
-        }
-        
-        if(mode == REMOVE_ON_RATIO)
-        {
-            UMapBuilderLib::RemoveRoomsBelowRatio(MapInfo, (1.f / 3.f));
-            cout << "After ratio reduction #rooms=" << MapInfo.Rooms.size() << "\n";
-            roomCount = MapInfo.Rooms.size();
-            mode++;
-        }
-        
-        drawRooms(window);
-        
-        if(mode >= FILTER_ROOMS)
+        if(snapshot.Stage >= FILTER_ROOMS)
         {
             drawFilters(window);
         }
-        if(mode >= FILTER_CORRIDOR_FEATURES)
-        {
-            drawCorridorFeatures(window);
-        }
-        if(mode > CALC_CONNECTIONS && mode <= DELAUNAY_DRAW_DELAY)
-        {
-            drawRoomPoints(window, tri->point);
-            drawDelaunayEdge(window, tri->edge, tri->point);
-        }
-        if(mode > DELAUNAY_DRAW_DELAY && mode <= BUILD_CORRIDORS)
-        {
-            drawMinSpan(window, *minSpan, tri->point);
-        }
-        if(mode > BUILD_CORRIDORS)
-        {
-            drawCorridors(window);
-        }
+        drawLayer(window, FeatureFillLayer);
+        drawLayer(window, FeatureLineLayer);
+        drawLayer(window, RoomPointLayer);
+        drawLayer(window, DelaunayLayer);
+        drawLayer(window, MinSpanLayer);
+        drawLayer(window, CorridorLayer);
+        drawLayer(window, DoorLayer);
         
         // Update the window
         window.display();
     }
     
-    delete tri;
-    delete minSpan;
+    // A stage already running is finished before the thread stops.
+    running = false;
+    generator.join();
     
     return EXIT_SUCCESS;
 }